@@ -0,0 +1,377 @@
+// Routing benchmarks for libtoqm, built as the toqm_bench target with
+// -DQISKIT_TOQM_BUILD_BENCHMARKS=ON.
+//
+// Each benchmark routes one circuit from a fixed corpus on one topology with
+// the mapper configuration of one of the presets in toqm_strategy_presets.py.
+// Besides wall time, each reports the nodes popped per second, the cycle
+// count of its result and the peak heap growth while it ran.
+
+#include <benchmark/benchmark.h>
+
+#include <libtoqm/ToqmMapper.hpp>
+#include <libtoqm/CostFunc/CXFrontier.hpp>
+#include <libtoqm/Expander/DefaultExpander.hpp>
+#include <libtoqm/Expander/GreedyTopK.hpp>
+#include <libtoqm/Filter/HashFilter.hpp>
+#include <libtoqm/Filter/HashFilter2.hpp>
+#include <libtoqm/Latency/Table.hpp>
+#include <libtoqm/NodeMod/GreedyMapper.hpp>
+#include <libtoqm/Queue/DefaultQueue.hpp>
+#include <libtoqm/Queue/TrimSlowNodes.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace toqm;
+
+namespace {
+
+// Heap accounting for the peak_heap_kb counter. The replacement global
+// operator new below prefixes each allocation with its size, so that
+// operator delete can keep track of the bytes currently allocated.
+std::atomic<std::size_t> live_bytes{0};
+std::atomic<std::size_t> peak_bytes{0};
+constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void * allocate(std::size_t size) noexcept {
+	auto * block = static_cast<char *>(std::malloc(size + HEADER_SIZE));
+	if (block == nullptr) {
+		return nullptr;
+	}
+
+	*reinterpret_cast<std::size_t *>(block) = size;
+	auto live = live_bytes += size;
+	auto peak = peak_bytes.load(std::memory_order_relaxed);
+	while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+	return block + HEADER_SIZE;
+}
+
+void deallocate(void * ptr) noexcept {
+	if (ptr == nullptr) {
+		return;
+	}
+
+	auto * block = static_cast<char *>(ptr) - HEADER_SIZE;
+	live_bytes -= *reinterpret_cast<std::size_t *>(block);
+	std::free(block);
+}
+
+struct Circuit {
+	std::vector<GateOp> gates;
+	std::size_t numQubits;
+};
+
+// Circuits
+
+Circuit qft(std::size_t n) {
+	Circuit c{{}, n};
+	int uid = 0;
+	for (int i = 0; i < static_cast<int>(n); i++) {
+		c.gates.emplace_back(uid++, "h", i);
+		for (int j = i + 1; j < static_cast<int>(n); j++) {
+			// Controlled phase, decomposed into CX and RZ.
+			c.gates.emplace_back(uid++, "cx", j, i);
+			c.gates.emplace_back(uid++, "rz", i);
+			c.gates.emplace_back(uid++, "cx", j, i);
+		}
+	}
+	return c;
+}
+
+Circuit randomLayers(std::size_t n, std::size_t layers) {
+	Circuit c{{}, n};
+	std::mt19937 rng(1234);
+	std::vector<int> qubits(n);
+	for (std::size_t i = 0; i < n; i++) {
+		qubits[i] = static_cast<int>(i);
+	}
+
+	int uid = 0;
+	for (std::size_t l = 0; l < layers; l++) {
+		std::shuffle(qubits.begin(), qubits.end(), rng);
+		for (std::size_t i = 0; i + 1 < n; i += 2) {
+			c.gates.emplace_back(uid++, "cx", qubits[i], qubits[i + 1]);
+		}
+	}
+	return c;
+}
+
+// A QASMBench-style hardware-efficient ansatz: alternating rotation layers
+// and CX ladders.
+Circuit ansatz(std::size_t n, std::size_t reps) {
+	Circuit c{{}, n};
+	int uid = 0;
+	for (std::size_t r = 0; r < reps; r++) {
+		for (int i = 0; i < static_cast<int>(n); i++) {
+			c.gates.emplace_back(uid++, "ry", i);
+		}
+		for (int i = 0; i + 1 < static_cast<int>(n); i++) {
+			c.gates.emplace_back(uid++, "cx", i, i + 1);
+		}
+	}
+	return c;
+}
+
+// Topologies
+
+CouplingMap bidirectional(unsigned int n, const std::vector<std::pair<int, int>> & edges) {
+	CouplingMap map{n, {}};
+	for (const auto & e : edges) {
+		map.edges.emplace(e.first, e.second);
+		map.edges.emplace(e.second, e.first);
+	}
+	return map;
+}
+
+CouplingMap line(unsigned int n) {
+	std::vector<std::pair<int, int>> edges;
+	for (int i = 0; i + 1 < static_cast<int>(n); i++) {
+		edges.emplace_back(i, i + 1);
+	}
+	return bidirectional(n, edges);
+}
+
+CouplingMap grid(int rows, int cols) {
+	std::vector<std::pair<int, int>> edges;
+	for (int r = 0; r < rows; r++) {
+		for (int c = 0; c < cols; c++) {
+			if (c + 1 < cols) {
+				edges.emplace_back(r * cols + c, r * cols + c + 1);
+			}
+			if (r + 1 < rows) {
+				edges.emplace_back(r * cols + c, (r + 1) * cols + c);
+			}
+		}
+	}
+	return bidirectional(static_cast<unsigned int>(rows * cols), edges);
+}
+
+// 27-qubit heavy-hex (Falcon).
+CouplingMap heavyHex27() {
+	return bidirectional(27, {
+			{0, 1}, {1, 2}, {1, 4}, {2, 3}, {3, 5}, {4, 7}, {5, 8}, {6, 7}, {7, 10}, {8, 9}, {8, 11},
+			{10, 12}, {11, 14}, {12, 13}, {12, 15}, {13, 14}, {14, 16}, {15, 18}, {16, 19}, {17, 18},
+			{18, 21}, {19, 20}, {19, 22}, {21, 23}, {22, 25}, {23, 24}, {24, 25}, {25, 26}
+	});
+}
+
+// Heavy-hex with the row layout of the 65-qubit (Hummingbird, width 11) and
+// 127-qubit (Eagle, width 15) devices. The first row is missing its last
+// column and the last row its first column. Consecutive rows are joined by
+// bridge qubits every 4 columns, starting at column 0 or 2 alternately.
+CouplingMap heavyHex(int rows, int width) {
+	auto bridge_offset = [](int gap) { return gap % 2 == 0 ? 0 : 2; };
+
+	// Qubit indices are allocated row by row, each row followed by the
+	// bridges below it. Column c of row r is qubit row_start[r] + c.
+	std::vector<int> row_start(rows);
+	std::vector<int> bridge_start(rows);
+	int next = 0;
+	for (int r = 0; r < rows; r++) {
+		int first_col = r == rows - 1 ? 1 : 0;
+		int last_col = r == 0 ? width - 2 : width - 1;
+		row_start[r] = next - first_col;
+		next += last_col - first_col + 1;
+
+		bridge_start[r] = next;
+		if (r < rows - 1) {
+			next += (width - bridge_offset(r) + 3) / 4;
+		}
+	}
+
+	std::vector<std::pair<int, int>> edges;
+	for (int r = 0; r < rows; r++) {
+		int first_col = r == rows - 1 ? 1 : 0;
+		int last_col = r == 0 ? width - 2 : width - 1;
+		for (int c = first_col; c < last_col; c++) {
+			edges.emplace_back(row_start[r] + c, row_start[r] + c + 1);
+		}
+
+		if (r < rows - 1) {
+			int bridge = bridge_start[r];
+			for (int c = bridge_offset(r); c < width; c += 4, bridge++) {
+				edges.emplace_back(row_start[r] + c, bridge);
+				edges.emplace_back(bridge, row_start[r + 1] + c);
+			}
+		}
+	}
+
+	return bidirectional(static_cast<unsigned int>(next), edges);
+}
+
+// Mapper configurations, matching toqm_strategy_presets.py.
+
+std::unique_ptr<Latency> presetLatency() {
+	return std::unique_ptr<Latency>(new Table({
+			LatencyDescription(1, 1),
+			LatencyDescription(2, 2),
+			LatencyDescription(2, "swap", 6)
+	}));
+}
+
+std::unique_ptr<ToqmMapper> heuristic(unsigned int top_k, int queue_target, int queue_max) {
+	std::vector<std::unique_ptr<NodeMod>> node_mods;
+	node_mods.emplace_back(new GreedyMapper());
+
+	auto mapper = std::unique_ptr<ToqmMapper>(new ToqmMapper(
+			TrimSlowNodes(queue_max, queue_target),
+			std::unique_ptr<Expander>(new GreedyTopK(top_k)),
+			std::unique_ptr<CostFunc>(new CXFrontier()),
+			presetLatency(),
+			std::move(node_mods),
+			{},
+			0));
+	mapper->setRetainPopped(1);
+	return mapper;
+}
+
+std::unique_ptr<ToqmMapper> optimal() {
+	std::vector<std::unique_ptr<Filter>> filters;
+	filters.emplace_back(new HashFilter());
+	filters.emplace_back(new HashFilter2());
+
+	return std::unique_ptr<ToqmMapper>(new ToqmMapper(
+			DefaultQueue(),
+			std::unique_ptr<Expander>(new DefaultExpander()),
+			std::unique_ptr<CostFunc>(new CXFrontier()),
+			presetLatency(),
+			{},
+			std::move(filters),
+			-1));
+}
+
+std::unique_ptr<ToqmMapper> preset(int level) {
+	switch (level) {
+		case 0:
+			return heuristic(1, 3000, 5000);
+		case 1:
+			return heuristic(5, 400, 800);
+		case 2:
+			return heuristic(11, 400, 100);
+		default:
+			return heuristic(3, 3600, 4800);
+	}
+}
+
+void route(benchmark::State & state, std::unique_ptr<ToqmMapper> mapper, Circuit circuit, CouplingMap coupling_map) {
+	long popped = 0;
+	int cycles = 0;
+
+	// Measure the peak from what this benchmark already holds, so that each
+	// benchmark reports its own usage rather than the process's high-water mark.
+	auto baseline = live_bytes.load();
+	peak_bytes = baseline;
+
+	for (auto _ : state) {
+		auto result = mapper->run(circuit.gates, circuit.numQubits, coupling_map);
+		popped += result->numPopped;
+
+		cycles = 0;
+		for (const auto & g : result->scheduledGates) {
+			cycles = std::max(cycles, g.cycle + g.latency);
+		}
+
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.counters["nodes_per_second"] = benchmark::Counter(static_cast<double>(popped), benchmark::Counter::kIsRate);
+	state.counters["cycles"] = cycles;
+	state.counters["peak_heap_kb"] = static_cast<double>(peak_bytes.load() - baseline) / 1024;
+}
+
+void registerAll() {
+	const std::vector<std::pair<std::string, CouplingMap>> topologies{
+			{"line16", line(16)},
+			{"grid4x4", grid(4, 4)},
+			{"heavyhex27", heavyHex27()},
+			{"heavyhex65", heavyHex(5, 11)},
+			{"heavyhex127", heavyHex(7, 15)},
+	};
+
+	for (const auto & topology : topologies) {
+		auto n = topology.second.numPhysicalQubits;
+		const std::vector<std::pair<std::string, Circuit>> circuits{
+				{"qft", qft(std::min<std::size_t>(n, 16))},
+				{"random_cx", randomLayers(n, 20)},
+				{"ansatz", ansatz(n, 4)},
+		};
+
+		for (const auto & circuit : circuits) {
+			for (int level = 0; level <= 3; level++) {
+				auto name = "O" + std::to_string(level) + "/" + topology.first + "/" + circuit.first;
+				benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State & state) {
+					route(state, preset(level), circuit.second, topology.second);
+				})->Unit(benchmark::kMillisecond);
+			}
+		}
+	}
+
+	// The optimal strategy is only used by the presets for devices under 6 qubits.
+	benchmark::RegisterBenchmark("optimal/line5/qft", [](benchmark::State & state) {
+		route(state, optimal(), qft(5), line(5));
+	})->Unit(benchmark::kMillisecond);
+}
+
+}
+
+void * operator new(std::size_t size) {
+	auto * ptr = allocate(size);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void * operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return allocate(size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return allocate(size);
+}
+
+void operator delete(void * ptr) noexcept {
+	deallocate(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+	deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+	deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+	deallocate(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept {
+	deallocate(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept {
+	deallocate(ptr);
+}
+
+int main(int argc, char ** argv) {
+	registerAll();
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,106 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2022.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+
+"""
+End-to-end routing benchmarks for ``ToqmSwap``, using pytest-benchmark.
+
+Run with::
+
+    pytest benchmarks/python/bench_toqm_swap.py
+
+Results include the cost of converting the DAG to native gates and of
+rebuilding the mapped DAG, in addition to the native search itself.
+"""
+
+import pytest
+
+pytest.importorskip("pytest_benchmark")
+
+from qiskit import QuantumCircuit, transpile
+from qiskit.circuit.library import QFT
+from qiskit.circuit.random import random_circuit
+from qiskit.converters import circuit_to_dag
+from qiskit.transpiler import CouplingMap, Layout, PassManager
+from qiskit.transpiler.passes import ApplyLayout, EnlargeWithAncilla, FullAncillaAllocation, SetLayout
+
+from qiskit_toqm import ToqmStrategyO0, ToqmStrategyO1, ToqmStrategyO2, ToqmStrategyO3, ToqmSwap
+
+PRESETS = {
+    "O0": ToqmStrategyO0,
+    "O1": ToqmStrategyO1,
+    "O2": ToqmStrategyO2,
+    "O3": ToqmStrategyO3,
+}
+
+TOPOLOGIES = {
+    "line16": lambda: CouplingMap.from_line(16),
+    "grid4x4": lambda: CouplingMap.from_grid(4, 4),
+    "heavyhex19": lambda: CouplingMap.from_heavy_hex(3),
+}
+
+
+def _qft(num_qubits):
+    return transpile(QFT(num_qubits), basis_gates=["cx", "rz", "sx", "x"], optimization_level=0)
+
+
+def _random_cx(num_qubits):
+    circuit = random_circuit(num_qubits, depth=20, max_operands=2, seed=1234)
+    return transpile(circuit, basis_gates=["cx", "rz", "sx", "x"], optimization_level=0)
+
+
+def _ansatz(num_qubits):
+    circuit = QuantumCircuit(num_qubits)
+    for _ in range(4):
+        for q in range(num_qubits):
+            circuit.ry(0.1, q)
+        for q in range(num_qubits - 1):
+            circuit.cx(q, q + 1)
+    return circuit
+
+
+CIRCUITS = {
+    "qft": _qft,
+    "random_cx": _random_cx,
+    "ansatz": _ansatz,
+}
+
+
+def _physical_dag(circuit, coupling_map):
+    """Lays ``circuit`` out trivially on ``coupling_map`` and returns it as a DAG with its layout."""
+    pm = PassManager([
+        SetLayout(Layout.generate_trivial_layout(*circuit.qregs)),
+        FullAncillaAllocation(coupling_map),
+        EnlargeWithAncilla(),
+        ApplyLayout(),
+    ])
+
+    physical = pm.run(circuit)
+    return circuit_to_dag(physical), pm.property_set["layout"]
+
+
+@pytest.mark.parametrize("preset", PRESETS)
+@pytest.mark.parametrize("topology", TOPOLOGIES)
+@pytest.mark.parametrize("circuit", CIRCUITS)
+def test_toqm_swap_run(benchmark, preset, topology, circuit):
+    coupling_map = TOPOLOGIES[topology]()
+    num_qubits = min(coupling_map.size(), 12)
+    dag, layout = _physical_dag(CIRCUITS[circuit](num_qubits), coupling_map)
+
+    routing_pass = ToqmSwap(coupling_map, PRESETS[preset]([]))
+
+    def run():
+        routing_pass.property_set["layout"] = layout.copy()
+        return routing_pass.run(dag)
+
+    benchmark(run)
+    benchmark.extra_info["cycles"] = routing_pass.toqm_result.stats["total_cycles"]
+    benchmark.extra_info["num_popped"] = routing_pass.toqm_result.numPopped
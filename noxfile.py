@@ -19,3 +19,12 @@ def tests(session: nox.Session) -> None:
     """
     session.install(".[test]")
     session.run("pytest", *session.posargs)
+
+
+@nox.session
+def bench(session: nox.Session) -> None:
+    """
+    Run the Python routing benchmarks.
+    """
+    session.install(".[bench]")
+    session.run("pytest", "benchmarks/python/bench_toqm_swap.py", *session.posargs)
@@ -1,4 +1,5 @@
+from .toqm_cache import ToqmCachedResult, ToqmDiskCache, ToqmMemoryCache
 from .toqm_latency import latencies_from_target, latencies_from_simple
-from .toqm_strategy import ToqmHeuristicStrategy, ToqmOptimalStrategy
+from .toqm_strategy import ToqmHeuristicStrategy, ToqmOptimalStrategy, ToqmStrategy
 from .toqm_strategy_presets import ToqmStrategyO0, ToqmStrategyO1, ToqmStrategyO2, ToqmStrategyO3
 from .toqm_swap import ToqmSwap
@@ -0,0 +1,39 @@
+#ifndef QISKIT_TOQM_CANCELLATION_HPP
+#define QISKIT_TOQM_CANCELLATION_HPP
+
+#include <atomic>
+#include <stdexcept>
+
+namespace qiskit_toqm {
+
+/**
+ * Thrown when routing is abandoned because its CancellationToken was cancelled.
+ */
+class RoutingCancelled : public std::runtime_error {
+public:
+	RoutingCancelled() : std::runtime_error("Routing was cancelled.") {}
+};
+
+/**
+ * A flag that can be set from any thread to ask in-flight routing to stop.
+ *
+ * Routing polls the token between circuits; a search that has already
+ * started runs to completion.
+ */
+class CancellationToken {
+public:
+	void cancel() {
+		cancelled.store(true, std::memory_order_relaxed);
+	}
+
+	bool isCancelled() const {
+		return cancelled.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<bool> cancelled{false};
+};
+
+}
+
+#endif //QISKIT_TOQM_CANCELLATION_HPP
@@ -0,0 +1,117 @@
+#include "GateArrays.hpp"
+
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+using namespace toqm;
+namespace py = pybind11;
+
+namespace qiskit_toqm {
+
+GateArrays::GateArrays(IndexArray uids,
+					   IndexArray types,
+					   IndexArray controls,
+					   IndexArray targets,
+					   std::vector<std::string> names)
+		: uids(std::move(uids)),
+		  types(std::move(types)),
+		  controls(std::move(controls)),
+		  targets(std::move(targets)),
+		  names(std::move(names)) {
+	for (const auto * array : {&this->uids, &this->types, &this->controls, &this->targets}) {
+		if (array->ndim() != 1) {
+			throw std::invalid_argument("Gate arrays must be one-dimensional.");
+		}
+
+		if (array->shape(0) != this->uids.shape(0)) {
+			throw std::invalid_argument("Gate arrays must all have the same length.");
+		}
+	}
+}
+
+GateArrays GateArrays::fromNodes(const py::sequence & nodes, const py::dict & qubit_indices) {
+	auto num_gates = static_cast<py::ssize_t>(nodes.size());
+	IndexArray uids(num_gates);
+	IndexArray types(num_gates);
+	IndexArray controls(num_gates);
+	IndexArray targets(num_gates);
+
+	auto uid_view = uids.mutable_unchecked<1>();
+	auto type_view = types.mutable_unchecked<1>();
+	auto control_view = controls.mutable_unchecked<1>();
+	auto target_view = targets.mutable_unchecked<1>();
+
+	std::unordered_map<std::string, std::int32_t> type_index{};
+	std::vector<std::string> names{};
+
+	auto index_of = [&](py::handle qubit) {
+		return qubit_indices[qubit].cast<std::int32_t>();
+	};
+
+	for (py::ssize_t i = 0; i < num_gates; i++) {
+		auto node = nodes[i];
+		auto name = node.attr("op").attr("name").cast<std::string>();
+		auto qargs = node.attr("qargs").cast<py::sequence>();
+
+		auto inserted = type_index.emplace(name, static_cast<std::int32_t>(names.size()));
+		if (inserted.second) {
+			names.push_back(name);
+		}
+
+		uid_view(i) = static_cast<std::int32_t>(i);
+		type_view(i) = inserted.first->second;
+
+		if (qargs.size() == 2) {
+			control_view(i) = index_of(qargs[0]);
+			target_view(i) = index_of(qargs[1]);
+		} else if (qargs.size() == 1) {
+			control_view(i) = -1;
+			target_view(i) = index_of(qargs[0]);
+		} else {
+			throw std::invalid_argument("ToqmSwap only works with 1q and 2q gates! Bad gate: " + name + " "
+										+ py::repr(qargs).cast<std::string>());
+		}
+	}
+
+	return GateArrays(std::move(uids), std::move(types), std::move(controls), std::move(targets), std::move(names));
+}
+
+std::size_t GateArrays::size() const {
+	return static_cast<std::size_t>(uids.shape(0));
+}
+
+std::vector<GateOp> GateArrays::toGateOps(std::size_t num_qubits) const {
+	auto uid_view = uids.unchecked<1>();
+	auto type_view = types.unchecked<1>();
+	auto control_view = controls.unchecked<1>();
+	auto target_view = targets.unchecked<1>();
+
+	auto in_range = [&](std::int32_t qubit) {
+		return qubit >= 0 && static_cast<std::size_t>(qubit) < num_qubits;
+	};
+
+	std::vector<GateOp> gate_ops{};
+	gate_ops.reserve(size());
+
+	for (pybind11::ssize_t i = 0; i < uid_view.shape(0); i++) {
+		auto type = type_view(i);
+		if (type < 0 || static_cast<std::size_t>(type) >= names.size()) {
+			throw std::invalid_argument("Gate type id is not in the name table.");
+		}
+
+		if (!in_range(target_view(i)) || (control_view(i) >= 0 && !in_range(control_view(i)))) {
+			throw std::invalid_argument("Gate acts on a qubit outside the circuit.");
+		}
+
+		if (control_view(i) >= 0) {
+			gate_ops.emplace_back(uid_view(i), names[type], control_view(i), target_view(i));
+		} else {
+			gate_ops.emplace_back(uid_view(i), names[type], target_view(i));
+		}
+	}
+
+	return gate_ops;
+}
+
+}
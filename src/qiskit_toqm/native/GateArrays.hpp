@@ -0,0 +1,58 @@
+#ifndef QISKIT_TOQM_GATE_ARRAYS_HPP
+#define QISKIT_TOQM_GATE_ARRAYS_HPP
+
+#include <pybind11/numpy.h>
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace qiskit_toqm {
+
+/**
+ * A topologically ordered gate list stored column-wise in NumPy arrays.
+ *
+ * Gate i has uid uids[i] and type names[types[i]], and acts on qubits
+ * controls[i] and targets[i]. A negative control denotes a 1Q gate.
+ * The arrays are referenced, not copied, until the gates are converted
+ * for a run, so they must already be C-contiguous int32 arrays.
+ */
+struct GateArrays {
+	using IndexArray = pybind11::array_t<std::int32_t, pybind11::array::c_style>;
+
+	GateArrays(IndexArray uids,
+			   IndexArray types,
+			   IndexArray controls,
+			   IndexArray targets,
+			   std::vector<std::string> names);
+
+	/**
+	 * Builds gate arrays from a topologically ordered sequence of DAG op
+	 * nodes, giving node i uid i. qubit_indices maps each qubit of the DAG to
+	 * its index. Throws std::invalid_argument for nodes that act on neither
+	 * 1 nor 2 qubits.
+	 */
+	static GateArrays fromNodes(const pybind11::sequence & nodes, const pybind11::dict & qubit_indices);
+
+	std::size_t size() const;
+
+	/**
+	 * Builds the native gate list. Must be called with the GIL held.
+	 *
+	 * Throws std::invalid_argument if a type id is not in the name table, or
+	 * a gate acts on a qubit outside [0, num_qubits).
+	 */
+	std::vector<toqm::GateOp> toGateOps(std::size_t num_qubits) const;
+
+	IndexArray uids;
+	IndexArray types;
+	IndexArray controls;
+	IndexArray targets;
+	std::vector<std::string> names;
+};
+
+}
+
+#endif //QISKIT_TOQM_GATE_ARRAYS_HPP
@@ -0,0 +1,40 @@
+#include "Instrumentation.hpp"
+
+#include <pybind11/stl.h>
+
+#include "Mapper.hpp"
+#include "ResultArrays.hpp"
+
+#include <algorithm>
+
+using namespace toqm;
+namespace py = pybind11;
+
+namespace qiskit_toqm {
+
+py::object withStats(std::unique_ptr<ToqmResult> result, const RunTimings & timings) {
+	const auto & gates = result->scheduledGates;
+	auto num_swaps = std::count_if(gates.begin(), gates.end(), [](const ScheduledGateOp & g) {
+		return isSwap(g.gateOp.type);
+	});
+	
+	py::dict stats;
+	stats["num_popped"] = result->numPopped;
+	stats["remaining_in_queue"] = result->remainingInQueue;
+	stats["filter_stats"] = py::cast(result->filterStats);
+	stats["num_scheduled_gates"] = gates.size();
+	stats["num_swaps"] = num_swaps;
+	stats["total_cycles"] = Mapper::totalCycles(*result);
+#ifdef QISKIT_TOQM_INSTRUMENTATION
+	stats["convert_ns"] = timings.convertNanoseconds;
+	stats["search_ns"] = timings.searchNanoseconds;
+#else
+	static_cast<void>(timings);
+#endif
+	
+	py::object py_result = py::cast(std::move(result));
+	py_result.attr("stats") = stats;
+	return py_result;
+}
+
+}
@@ -0,0 +1,40 @@
+#ifndef QISKIT_TOQM_INSTRUMENTATION_HPP
+#define QISKIT_TOQM_INSTRUMENTATION_HPP
+
+#include <pybind11/pybind11.h>
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include "Timing.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace qiskit_toqm {
+
+/**
+ * Converts result to Python and sets its "stats" attribute to a dict of
+ * counters derived from the result, plus the given timings when built with
+ * QISKIT_TOQM_INSTRUMENTATION.
+ */
+pybind11::object withStats(std::unique_ptr<toqm::ToqmResult> result, const RunTimings & timings);
+
+/**
+ * Calls run with the GIL released, timing it as the search phase, and
+ * returns its result with stats attached.
+ */
+template<typename Run>
+pybind11::object timedRun(RunTimings timings, Run run) {
+	std::unique_ptr<toqm::ToqmResult> result{};
+	{
+		pybind11::gil_scoped_release release;
+		ScopedTimer timer(timings.searchNanoseconds);
+		result = run();
+	}
+	
+	return withStats(std::move(result), timings);
+}
+
+}
+
+#endif //QISKIT_TOQM_INSTRUMENTATION_HPP
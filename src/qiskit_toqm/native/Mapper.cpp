@@ -0,0 +1,253 @@
+#include "Mapper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace toqm;
+
+namespace qiskit_toqm {
+
+Mapper::Mapper(const Queue & node_queue,
+			   std::unique_ptr<Expander> expander,
+			   std::unique_ptr<CostFunc> cost_func,
+			   std::unique_ptr<Latency> latency,
+			   std::vector<std::unique_ptr<NodeMod>> node_mods,
+			   std::vector<std::unique_ptr<Filter>> filters,
+			   int initial_search_cycles)
+		: node_queue(node_queue.clone()),
+		  expander(std::move(expander)),
+		  cost_func(std::move(cost_func)),
+		  latency(std::move(latency)),
+		  node_mods(std::move(node_mods)),
+		  filters(std::move(filters)),
+		  initial_search_cycles(initial_search_cycles) {
+	mapper = build(initial_search_cycles);
+}
+
+void Mapper::setRetainPopped(int retain_popped) {
+	this->has_retain_popped = true;
+	this->retain_popped = retain_popped;
+	mapper->setRetainPopped(retain_popped);
+}
+
+void Mapper::setVerbose(bool verbose) {
+	this->verbose = verbose;
+	mapper->setVerbose(verbose);
+}
+
+std::unique_ptr<ToqmResult> Mapper::run(const std::vector<GateOp> & gate_ops,
+										std::size_t num_qubits,
+										const CouplingMap & coupling_map) const {
+	return mapper->run(gate_ops, num_qubits, coupling_map);
+}
+
+std::unique_ptr<ToqmResult> Mapper::run(const std::vector<GateOp> & gate_ops,
+										std::size_t num_qubits,
+										const CouplingMap & coupling_map,
+										const std::vector<int> & init_qal) const {
+	return mapper->run(gate_ops, num_qubits, coupling_map, init_qal);
+}
+
+std::vector<std::unique_ptr<ToqmResult>> Mapper::runBatch(const std::vector<std::vector<GateOp>> & gate_ops_list,
+														  const std::vector<std::size_t> & num_qubits_list,
+														  const CouplingMap & coupling_map,
+														  unsigned int num_threads,
+														  const CancellationToken * cancellation_token,
+														  std::vector<RunTimings> * timings) const {
+	if (gate_ops_list.size() != num_qubits_list.size()) {
+		throw std::invalid_argument("The number of gate lists must match the number of qubit counts.");
+	}
+
+	std::vector<std::exception_ptr> errors;
+	std::vector<RunTimings> circuit_timings;
+	auto results = runParallel(gate_ops_list.size(), num_threads, initial_search_cycles, cancellation_token, errors,
+							   circuit_timings,
+							   [&](const ToqmMapper & worker_mapper, std::size_t i) {
+								   return worker_mapper.run(gate_ops_list[i], num_qubits_list[i], coupling_map);
+							   });
+
+	finishBatch(errors, circuit_timings, timings);
+	return results;
+}
+
+std::vector<std::unique_ptr<ToqmResult>> Mapper::runBatch(const std::vector<const PreparedCircuit *> & circuits,
+														  const CouplingMap & coupling_map,
+														  unsigned int num_threads,
+														  const CancellationToken * cancellation_token,
+														  std::vector<RunTimings> * timings) const {
+	std::vector<std::exception_ptr> errors;
+	std::vector<RunTimings> circuit_timings;
+	auto results = runParallel(circuits.size(), num_threads, initial_search_cycles, cancellation_token, errors,
+							   circuit_timings,
+							   [&](const ToqmMapper & worker_mapper, std::size_t i) {
+								   return worker_mapper.run(circuits[i]->gateOps, circuits[i]->numQubits, coupling_map);
+							   });
+
+	finishBatch(errors, circuit_timings, timings);
+	return results;
+}
+
+std::unique_ptr<ToqmResult> Mapper::runPortfolio(const std::vector<GateOp> & gate_ops,
+												 std::size_t num_qubits,
+												 const CouplingMap & coupling_map,
+												 const std::vector<std::vector<int>> & init_qals,
+												 unsigned int num_threads,
+												 const CancellationToken * cancellation_token,
+												 RunTimings * timings) const {
+	if (init_qals.empty()) {
+		throw std::invalid_argument("At least one initial layout is required.");
+	}
+
+	std::vector<std::exception_ptr> errors;
+	std::vector<RunTimings> seed_timings;
+	// A layout search would permute the seeds, so none is run.
+	auto results = runParallel(init_qals.size(), num_threads, 0, cancellation_token, errors, seed_timings,
+							   [&](const ToqmMapper & worker_mapper, std::size_t i) {
+								   return worker_mapper.run(gate_ops, num_qubits, coupling_map, init_qals[i]);
+							   });
+
+	std::unique_ptr<ToqmResult> best{};
+	int best_cycles = 0;
+	for (std::size_t i = 0; i < results.size(); i++) {
+		if (!results[i]) {
+			continue;
+		}
+
+		auto cycles = totalCycles(*results[i]);
+		if (!best || cycles < best_cycles) {
+			best = std::move(results[i]);
+			best_cycles = cycles;
+
+			if (timings != nullptr) {
+				*timings = seed_timings[i];
+			}
+		}
+	}
+
+	if (!best) {
+		// Every seed failed, so report the first failure.
+		std::rethrow_exception(errors.front());
+	}
+
+	return best;
+}
+
+int Mapper::totalCycles(const ToqmResult & result) {
+	int cycles = 0;
+	for (const auto & g : result.scheduledGates) {
+		cycles = std::max(cycles, g.cycle + g.latency);
+	}
+
+	return cycles;
+}
+
+std::vector<std::unique_ptr<ToqmResult>> Mapper::runParallel(std::size_t count,
+															 unsigned int num_threads,
+															 int initial_search_cycles,
+															 const CancellationToken * cancellation_token,
+															 std::vector<std::exception_ptr> & errors,
+															 std::vector<RunTimings> & timings,
+															 const Route & route) const {
+	std::vector<std::unique_ptr<ToqmResult>> results(count);
+	errors.assign(count, nullptr);
+	timings.assign(count, RunTimings{});
+
+	if (num_threads == 0) {
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	num_threads = static_cast<unsigned int>(std::min<std::size_t>(num_threads, count));
+
+	// Mappers are built up front (single threaded) so that component clone()
+	// implementations are never invoked concurrently.
+	std::vector<std::unique_ptr<ToqmMapper>> worker_mappers;
+	worker_mappers.reserve(num_threads);
+	for (unsigned int i = 0; i < num_threads; i++) {
+		worker_mappers.emplace_back(build(initial_search_cycles));
+	}
+
+	std::atomic<std::size_t> next{0};
+	std::atomic<bool> skipped{false};
+	auto work = [&](const ToqmMapper & worker_mapper) {
+		for (auto i = next++; i < count; i = next++) {
+			if (cancellation_token != nullptr && cancellation_token->isCancelled()) {
+				skipped = true;
+				return;
+			}
+
+			try {
+				ScopedTimer timer(timings[i].searchNanoseconds);
+				results[i] = route(worker_mapper, i);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(num_threads);
+	for (unsigned int i = 0; i < num_threads; i++) {
+		workers.emplace_back(work, std::cref(*worker_mappers[i]));
+	}
+
+	for (auto & worker : workers) {
+		worker.join();
+	}
+
+	if (skipped) {
+		throw RoutingCancelled();
+	}
+
+	return results;
+}
+
+void Mapper::finishBatch(const std::vector<std::exception_ptr> & errors,
+						 std::vector<RunTimings> & route_timings,
+						 std::vector<RunTimings> * timings) {
+	for (const auto & error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	if (timings != nullptr) {
+		*timings = std::move(route_timings);
+	}
+}
+
+std::unique_ptr<ToqmMapper> Mapper::build(int initial_search_cycles) const {
+	std::vector<std::unique_ptr<NodeMod>> nms{};
+	nms.reserve(node_mods.size());
+
+	for (const auto & nm : node_mods) {
+		nms.emplace_back(nm->clone());
+	}
+
+	std::vector<std::unique_ptr<Filter>> fs{};
+	fs.reserve(filters.size());
+
+	for (const auto & f : filters) {
+		fs.emplace_back(f->clone());
+	}
+
+	auto built = std::unique_ptr<ToqmMapper>(new ToqmMapper(
+			*node_queue,
+			expander->clone(),
+			cost_func->clone(),
+			latency->clone(),
+			std::move(nms),
+			std::move(fs),
+			initial_search_cycles));
+
+	if (has_retain_popped) {
+		built->setRetainPopped(retain_popped);
+	}
+	built->setVerbose(verbose);
+
+	return built;
+}
+
+}
@@ -0,0 +1,154 @@
+#ifndef QISKIT_TOQM_MAPPER_HPP
+#define QISKIT_TOQM_MAPPER_HPP
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include "Cancellation.hpp"
+#include "PreparedCircuit.hpp"
+#include "Timing.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace qiskit_toqm {
+
+/**
+ * Python-facing wrapper around toqm::ToqmMapper.
+ *
+ * Keeps a prototype of every configured search component so that
+ * independent ToqmMapper instances can be built on demand, e.g. one per
+ * worker thread in runBatch.
+ */
+class Mapper {
+public:
+	Mapper(const toqm::Queue & node_queue,
+		   std::unique_ptr<toqm::Expander> expander,
+		   std::unique_ptr<toqm::CostFunc> cost_func,
+		   std::unique_ptr<toqm::Latency> latency,
+		   std::vector<std::unique_ptr<toqm::NodeMod>> node_mods,
+		   std::vector<std::unique_ptr<toqm::Filter>> filters,
+		   int initial_search_cycles);
+
+	void setRetainPopped(int retain_popped);
+
+	void setVerbose(bool verbose);
+
+	std::unique_ptr<toqm::ToqmResult> run(const std::vector<toqm::GateOp> & gate_ops,
+										  std::size_t num_qubits,
+										  const toqm::CouplingMap & coupling_map) const;
+
+	std::unique_ptr<toqm::ToqmResult> run(const std::vector<toqm::GateOp> & gate_ops,
+										  std::size_t num_qubits,
+										  const toqm::CouplingMap & coupling_map,
+										  const std::vector<int> & init_qal) const;
+
+	/**
+	 * Route each circuit in gate_ops_list on the given coupling map.
+	 *
+	 * Circuits are distributed over num_threads workers (0 selects the
+	 * hardware concurrency). Each worker routes with its own ToqmMapper built
+	 * from clones of this mapper's components. If any circuit fails to route,
+	 * the first failure (in circuit order) is rethrown once all workers finish.
+	 *
+	 * If cancellation_token is given, workers check it before starting each
+	 * circuit, and RoutingCancelled is thrown if any circuit was skipped.
+	 *
+	 * If timings is given, it receives the search timings of each circuit.
+	 */
+	std::vector<std::unique_ptr<toqm::ToqmResult>> runBatch(const std::vector<std::vector<toqm::GateOp>> & gate_ops_list,
+															const std::vector<std::size_t> & num_qubits_list,
+															const toqm::CouplingMap & coupling_map,
+															unsigned int num_threads,
+															const CancellationToken * cancellation_token = nullptr,
+															std::vector<RunTimings> * timings = nullptr) const;
+
+	/**
+	 * Route each prepared circuit on the given coupling map, as in runBatch
+	 * above, without copying their gate lists.
+	 */
+	std::vector<std::unique_ptr<toqm::ToqmResult>> runBatch(const std::vector<const PreparedCircuit *> & circuits,
+															const toqm::CouplingMap & coupling_map,
+															unsigned int num_threads,
+															const CancellationToken * cancellation_token = nullptr,
+															std::vector<RunTimings> * timings = nullptr) const;
+
+	/**
+	 * Route the circuit once from each of the given initial layouts and return
+	 * the result with the fewest total cycles.
+	 *
+	 * Each seed is kept as given: the workers never search for an initial
+	 * layout, whatever this mapper's initial_search_cycles.
+	 *
+	 * Seeds are distributed over num_threads workers as in runBatch. Seeds that
+	 * fail to route are ignored unless all of them fail, in which case the
+	 * first failure is rethrown.
+	 *
+	 * If timings is given, it receives the search timings of the returned result.
+	 */
+	std::unique_ptr<toqm::ToqmResult> runPortfolio(const std::vector<toqm::GateOp> & gate_ops,
+												   std::size_t num_qubits,
+												   const toqm::CouplingMap & coupling_map,
+												   const std::vector<std::vector<int>> & init_qals,
+												   unsigned int num_threads,
+												   const CancellationToken * cancellation_token = nullptr,
+												   RunTimings * timings = nullptr) const;
+
+	/**
+	 * The number of cycles until the last scheduled gate of result completes.
+	 */
+	static int totalCycles(const toqm::ToqmResult & result);
+
+private:
+	using Route = std::function<std::unique_ptr<toqm::ToqmResult>(const toqm::ToqmMapper &, std::size_t)>;
+
+	/**
+	 * Builds a ToqmMapper from clones of this mapper's components that
+	 * searches for an initial layout for initial_search_cycles.
+	 */
+	std::unique_ptr<toqm::ToqmMapper> build(int initial_search_cycles) const;
+
+	/**
+	 * Rethrows the first error in errors, if any, and otherwise moves
+	 * route_timings into timings (if given).
+	 */
+	static void finishBatch(const std::vector<std::exception_ptr> & errors,
+							std::vector<RunTimings> & route_timings,
+							std::vector<RunTimings> * timings);
+
+	/**
+	 * Calls route for each index in [0, count) on up to num_threads workers,
+	 * each with its own ToqmMapper built with the given initial_search_cycles.
+	 * Exceptions thrown by route are stored in
+	 * errors by index, and the time spent in route in timings. Throws
+	 * RoutingCancelled if cancellation_token caused any index to be skipped.
+	 */
+	std::vector<std::unique_ptr<toqm::ToqmResult>> runParallel(std::size_t count,
+															   unsigned int num_threads,
+															   int initial_search_cycles,
+															   const CancellationToken * cancellation_token,
+															   std::vector<std::exception_ptr> & errors,
+															   std::vector<RunTimings> & timings,
+															   const Route & route) const;
+
+	std::unique_ptr<toqm::Queue> node_queue;
+	std::unique_ptr<toqm::Expander> expander;
+	std::unique_ptr<toqm::CostFunc> cost_func;
+	std::unique_ptr<toqm::Latency> latency;
+	std::vector<std::unique_ptr<toqm::NodeMod>> node_mods;
+	std::vector<std::unique_ptr<toqm::Filter>> filters;
+	int initial_search_cycles;
+
+	// Settings applied through the setters, replayed onto every built mapper.
+	bool has_retain_popped = false;
+	int retain_popped = 0;
+	bool verbose = false;
+
+	std::unique_ptr<toqm::ToqmMapper> mapper;
+};
+
+}
+
+#endif //QISKIT_TOQM_MAPPER_HPP
@@ -0,0 +1,34 @@
+#include "PreparedCircuit.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using namespace toqm;
+
+namespace qiskit_toqm {
+
+PreparedCircuit::PreparedCircuit(std::vector<GateOp> gate_ops, std::size_t num_qubits)
+		: gateOps(std::move(gate_ops)),
+		  numQubits(num_qubits) {
+	auto in_range = [&](int qubit) {
+		return qubit >= 0 && static_cast<std::size_t>(qubit) < numQubits;
+	};
+
+	for (const auto & gate : gateOps) {
+		if (!in_range(gate.target) || (gate.control >= 0 && !in_range(gate.control))) {
+			throw std::invalid_argument("Gate acts on a qubit outside the circuit.");
+		}
+	}
+}
+
+std::size_t PreparedCircuit::size() const {
+	return gateOps.size();
+}
+
+void PreparedCircuit::checkNumQubits(std::size_t num_qubits) const {
+	if (num_qubits != numQubits) {
+		throw std::invalid_argument("The number of qubits does not match the prepared circuit.");
+	}
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef QISKIT_TOQM_PREPARED_CIRCUIT_HPP
+#define QISKIT_TOQM_PREPARED_CIRCUIT_HPP
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace qiskit_toqm {
+
+/**
+ * A circuit converted to its native form once, so that it can be routed
+ * repeatedly (e.g. by a fallback chain of strategies or a portfolio run)
+ * without converting the gate list again for each run.
+ */
+struct PreparedCircuit {
+	/**
+	 * Throws std::invalid_argument if a gate acts on a qubit outside
+	 * [0, num_qubits).
+	 */
+	PreparedCircuit(std::vector<toqm::GateOp> gate_ops, std::size_t num_qubits);
+
+	std::size_t size() const;
+
+	/**
+	 * Throws std::invalid_argument unless num_qubits is the number of
+	 * qubits this circuit was prepared with.
+	 */
+	void checkNumQubits(std::size_t num_qubits) const;
+
+	std::vector<toqm::GateOp> gateOps;
+	std::size_t numQubits;
+};
+
+}
+
+#endif //QISKIT_TOQM_PREPARED_CIRCUIT_HPP
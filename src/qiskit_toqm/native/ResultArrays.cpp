@@ -0,0 +1,90 @@
+#include "ResultArrays.hpp"
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace toqm;
+namespace py = pybind11;
+
+namespace qiskit_toqm {
+
+namespace {
+
+template<typename Field>
+py::array fieldView(const std::vector<ScheduledGateOp> & gates, Field field, const py::object & base) {
+	using T = std::remove_cv_t<std::remove_reference_t<decltype(field(gates.front()))>>;
+	
+	if (gates.empty()) {
+		return py::array_t<T>(0);
+	}
+	
+	// Each element of the view is the same field of consecutive ScheduledGateOps.
+	py::array_t<T> view({gates.size()}, {sizeof(ScheduledGateOp)}, &field(gates.front()), base);
+	view.attr("setflags")(py::arg("write") = false);
+	return view;
+}
+
+}
+
+bool isSwap(const std::string & type) {
+	return type.size() == 4 && std::equal(type.begin(), type.end(), "swap", [](char a, char b) {
+		return std::tolower(static_cast<unsigned char>(a)) == b;
+	});
+}
+
+py::dict scheduledGateArrays(const py::object & result) {
+	const auto & gates = result.cast<const ToqmResult &>().scheduledGates;
+	
+	py::array_t<bool> is_swap(gates.size());
+	auto is_swap_view = is_swap.mutable_unchecked<1>();
+	for (std::size_t i = 0; i < gates.size(); i++) {
+		is_swap_view(i) = isSwap(gates[i].gateOp.type);
+	}
+	
+	py::dict arrays;
+	arrays["uid"] = fieldView(gates, [](const ScheduledGateOp & g) -> const auto & { return g.gateOp.uid; }, result);
+	arrays["physicalControl"] = fieldView(gates, [](const ScheduledGateOp & g) -> const auto & { return g.physicalControl; }, result);
+	arrays["physicalTarget"] = fieldView(gates, [](const ScheduledGateOp & g) -> const auto & { return g.physicalTarget; }, result);
+	arrays["cycle"] = fieldView(gates, [](const ScheduledGateOp & g) -> const auto & { return g.cycle; }, result);
+	arrays["latency"] = fieldView(gates, [](const ScheduledGateOp & g) -> const auto & { return g.latency; }, result);
+	arrays["is_swap"] = is_swap;
+	return arrays;
+}
+
+py::dict scheduledNodeOrder(const py::object & result) {
+	const auto & gates = result.cast<const ToqmResult &>().scheduledGates;
+	
+	std::vector<int> uids, controls, targets;
+	std::vector<int> swap_index, swap_controls, swap_targets;
+	for (const auto & g : gates) {
+		if (isSwap(g.gateOp.type)) {
+			swap_index.push_back(static_cast<int>(uids.size()));
+			swap_controls.push_back(g.physicalControl);
+			swap_targets.push_back(g.physicalTarget);
+		} else {
+			uids.push_back(g.gateOp.uid);
+			controls.push_back(g.physicalControl);
+			targets.push_back(g.physicalTarget);
+		}
+	}
+	
+	auto to_array = [](const std::vector<int> & values) {
+		return py::array_t<int>(values.size(), values.data());
+	};
+	
+	py::dict arrays;
+	arrays["uid"] = to_array(uids);
+	arrays["physicalControl"] = to_array(controls);
+	arrays["physicalTarget"] = to_array(targets);
+	arrays["swap_index"] = to_array(swap_index);
+	arrays["swap_control"] = to_array(swap_controls);
+	arrays["swap_target"] = to_array(swap_targets);
+	return arrays;
+}
+
+}
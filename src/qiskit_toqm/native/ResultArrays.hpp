@@ -0,0 +1,38 @@
+#ifndef QISKIT_TOQM_RESULT_ARRAYS_HPP
+#define QISKIT_TOQM_RESULT_ARRAYS_HPP
+
+#include <pybind11/numpy.h>
+
+#include <string>
+
+namespace qiskit_toqm {
+
+/**
+ * Exports the schedule of a bound ToqmResult as a dict of NumPy arrays.
+ *
+ * The "uid", "physicalControl", "physicalTarget", "cycle" and "latency"
+ * arrays are read-only strided views into the result's scheduledGates and
+ * keep the result alive. "is_swap" is computed, since it is derived from
+ * the gate type name.
+ */
+pybind11::dict scheduledGateArrays(const pybind11::object & result);
+
+/**
+ * Splits the schedule of a bound ToqmResult into the circuit's own gates
+ * and the swaps inserted between them, for rebuilding the mapped circuit.
+ *
+ * "uid", "physicalControl" and "physicalTarget" hold the original gates in
+ * schedule order. The i-th swap, on "swap_control" and "swap_target", is
+ * applied just before the original gate at position "swap_index"[i] (or
+ * after all of them if it equals the number of original gates).
+ */
+pybind11::dict scheduledNodeOrder(const pybind11::object & result);
+
+/**
+ * Whether a scheduled gate type names a swap inserted by the mapper.
+ */
+bool isSwap(const std::string & type);
+
+}
+
+#endif //QISKIT_TOQM_RESULT_ARRAYS_HPP
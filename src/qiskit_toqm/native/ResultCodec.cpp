@@ -0,0 +1,241 @@
+#include "ResultCodec.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace toqm;
+
+namespace qiskit_toqm {
+
+namespace {
+
+const char MAGIC[] = {'T', 'Q', 'R'};
+const std::uint8_t VERSION = 1;
+
+class Writer {
+public:
+	void byte(std::uint8_t b) {
+		data.push_back(static_cast<char>(b));
+	}
+
+	void uvarint(std::uint64_t value) {
+		while (value >= 0x80) {
+			byte(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		byte(static_cast<std::uint8_t>(value));
+	}
+
+	void varint(std::int64_t value) {
+		uvarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+	}
+
+	void string(const std::string & value) {
+		uvarint(value.size());
+		data.append(value);
+	}
+
+	void ints(const std::vector<int> & values) {
+		uvarint(values.size());
+		for (auto value : values) {
+			varint(value);
+		}
+	}
+
+	std::string data;
+};
+
+class Reader {
+public:
+	explicit Reader(const std::string & data) : data(data) {}
+
+	std::uint8_t byte() {
+		if (pos >= data.size()) {
+			throw std::invalid_argument("Truncated ToqmResult encoding.");
+		}
+
+		return static_cast<std::uint8_t>(data[pos++]);
+	}
+
+	std::uint64_t uvarint() {
+		std::uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			auto b = byte();
+			value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+			if ((b & 0x80) == 0) {
+				return value;
+			}
+		}
+
+		throw std::invalid_argument("Malformed varint in ToqmResult encoding.");
+	}
+
+	int varint() {
+		auto value = uvarint();
+		return static_cast<int>(static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1));
+	}
+
+	/**
+	 * Reads a length, checking that at least that many bytes remain so that
+	 * a corrupt length cannot trigger a huge allocation.
+	 */
+	std::size_t length() {
+		auto n = uvarint();
+		if (n > data.size() - pos) {
+			throw std::invalid_argument("Truncated ToqmResult encoding.");
+		}
+
+		return static_cast<std::size_t>(n);
+	}
+
+	std::string string() {
+		auto n = length();
+		auto value = data.substr(pos, n);
+		pos += n;
+		return value;
+	}
+
+	std::vector<int> ints() {
+		std::vector<int> values(length());
+		for (auto & value : values) {
+			value = varint();
+		}
+
+		return values;
+	}
+
+	bool done() const {
+		return pos == data.size();
+	}
+
+private:
+	const std::string & data;
+	std::size_t pos = 0;
+};
+
+}
+
+std::string encodeResult(const ToqmResult & result) {
+	Writer w{};
+	for (auto c : MAGIC) {
+		w.byte(static_cast<std::uint8_t>(c));
+	}
+	w.byte(VERSION);
+
+	w.varint(result.remainingInQueue);
+	w.varint(result.numPhysicalQubits);
+	w.varint(result.numLogicalQubits);
+	w.varint(result.idealCycles);
+	w.varint(result.numPopped);
+	w.string(result.filterStats);
+	w.ints(result.laq);
+	w.ints(result.inferredQal);
+	w.ints(result.inferredLaq);
+
+	std::unordered_map<std::string, std::size_t> type_index{};
+	std::vector<const std::string *> types{};
+	std::vector<std::size_t> type_ids{};
+	type_ids.reserve(result.scheduledGates.size());
+
+	for (const auto & g : result.scheduledGates) {
+		auto inserted = type_index.emplace(g.gateOp.type, types.size());
+		if (inserted.second) {
+			types.push_back(&g.gateOp.type);
+		}
+		type_ids.push_back(inserted.first->second);
+	}
+
+	w.uvarint(types.size());
+	for (const auto * type : types) {
+		w.string(*type);
+	}
+
+	w.uvarint(result.scheduledGates.size());
+	int prev_cycle = 0;
+	for (std::size_t i = 0; i < result.scheduledGates.size(); i++) {
+		const auto & g = result.scheduledGates[i];
+		w.uvarint(type_ids[i]);
+		w.varint(g.gateOp.uid);
+		w.varint(g.gateOp.control);
+		w.varint(g.gateOp.target);
+		w.varint(g.physicalControl);
+		w.varint(g.physicalTarget);
+		w.varint(g.cycle - prev_cycle);
+		w.varint(g.latency);
+		prev_cycle = g.cycle;
+	}
+
+	return std::move(w.data);
+}
+
+std::unique_ptr<ToqmResult> decodeResult(const std::string & data) {
+	Reader r(data);
+	for (auto c : MAGIC) {
+		if (r.byte() != static_cast<std::uint8_t>(c)) {
+			throw std::invalid_argument("Not a ToqmResult encoding.");
+		}
+	}
+
+	if (r.byte() != VERSION) {
+		throw std::invalid_argument("Unsupported ToqmResult encoding version.");
+	}
+
+	auto result = std::unique_ptr<ToqmResult>(new ToqmResult());
+	result->remainingInQueue = r.varint();
+	result->numPhysicalQubits = r.varint();
+	result->numLogicalQubits = r.varint();
+	result->idealCycles = r.varint();
+	result->numPopped = r.varint();
+	result->filterStats = r.string();
+	result->laq = r.ints();
+	result->inferredQal = r.ints();
+	result->inferredLaq = r.ints();
+
+	std::vector<std::string> types(r.length());
+	for (auto & type : types) {
+		type = r.string();
+	}
+
+	auto num_gates = r.length();
+	result->scheduledGates.reserve(num_gates);
+
+	int cycle = 0;
+	for (std::size_t i = 0; i < num_gates; i++) {
+		auto type_id = r.uvarint();
+		if (type_id >= types.size()) {
+			throw std::invalid_argument("Gate type id is not in the encoded type table.");
+		}
+
+		auto uid = r.varint();
+		auto control = r.varint();
+		auto target = r.varint();
+		auto physical_control = r.varint();
+		auto physical_target = r.varint();
+		cycle += r.varint();
+		auto latency = r.varint();
+
+		auto gate_op = control >= 0
+				? GateOp(uid, types[type_id], control, target)
+				: GateOp(uid, types[type_id], target);
+
+		// GateOp has no default constructor, so only gateOp is initialized
+		// in place; the other fields are assigned by name.
+		result->scheduledGates.push_back(ScheduledGateOp{std::move(gate_op)});
+		auto & scheduled = result->scheduledGates.back();
+		scheduled.physicalTarget = physical_target;
+		scheduled.physicalControl = physical_control;
+		scheduled.cycle = cycle;
+		scheduled.latency = latency;
+	}
+
+	if (!r.done()) {
+		throw std::invalid_argument("Trailing data after ToqmResult encoding.");
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef QISKIT_TOQM_RESULT_CODEC_HPP
+#define QISKIT_TOQM_RESULT_CODEC_HPP
+
+#include <libtoqm/ToqmMapper.hpp>
+
+#include <memory>
+#include <string>
+
+namespace qiskit_toqm {
+
+/**
+ * Encodes result as a compact, versioned byte string.
+ *
+ * Integers are zigzag varints, gate type names are interned into a table,
+ * and the cycles of scheduled gates are stored as deltas from the previous
+ * gate, so a typical schedule takes a few bytes per gate.
+ */
+std::string encodeResult(const toqm::ToqmResult & result);
+
+/**
+ * Decodes a result encoded by encodeResult.
+ *
+ * Throws std::invalid_argument if data is not an encoded result of a
+ * supported version.
+ */
+std::unique_ptr<toqm::ToqmResult> decodeResult(const std::string & data);
+
+}
+
+#endif //QISKIT_TOQM_RESULT_CODEC_HPP
@@ -0,0 +1,44 @@
+#ifndef QISKIT_TOQM_TIMING_HPP
+#define QISKIT_TOQM_TIMING_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace qiskit_toqm {
+
+/**
+ * Wall-clock time spent in each phase of routing one circuit.
+ *
+ * Only collected when built with QISKIT_TOQM_INSTRUMENTATION; otherwise
+ * all timings stay zero.
+ */
+struct RunTimings {
+	std::int64_t convertNanoseconds = 0;
+	std::int64_t searchNanoseconds = 0;
+};
+
+/**
+ * Adds the time until it goes out of scope to the given counter.
+ */
+class ScopedTimer {
+public:
+#ifdef QISKIT_TOQM_INSTRUMENTATION
+	explicit ScopedTimer(std::int64_t & counter)
+			: counter(counter), start(std::chrono::steady_clock::now()) {}
+
+	~ScopedTimer() {
+		counter += std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count();
+	}
+
+private:
+	std::int64_t & counter;
+	std::chrono::steady_clock::time_point start;
+#else
+	explicit ScopedTimer(std::int64_t &) {}
+#endif
+};
+
+}
+
+#endif //QISKIT_TOQM_TIMING_HPP
@@ -2,6 +2,8 @@ from ._core import \
     __doc__, \
     __version__, \
     GateOp, \
+    GateArrays, \
+    PreparedCircuit, \
     CouplingMap, \
     ScheduledGateOp, \
     LatencyDescription, \
@@ -27,4 +29,6 @@ from ._core import \
     Table, \
     NodeMod, \
     GreedyMapper, \
-    ToqmMapper
\ No newline at end of file
+    ToqmMapper, \
+    CancellationToken, \
+    RoutingCancelled
\ No newline at end of file
@@ -17,14 +17,210 @@
 #include <libtoqm/NodeMod/GreedyMapper.hpp>
 #include <libtoqm/Queue/DefaultQueue.hpp>
 #include <libtoqm/Queue/TrimSlowNodes.hpp>
+#include <stdexcept>
 #include <utility>
 
+#include "Cancellation.hpp"
+#include "GateArrays.hpp"
+#include "Instrumentation.hpp"
+#include "Mapper.hpp"
+#include "PreparedCircuit.hpp"
+#include "ResultArrays.hpp"
+#include "ResultCodec.hpp"
+
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
 
 using namespace toqm;
 namespace py = pybind11;
 
+namespace {
+
+std::vector<GateOp> convert(const qiskit_toqm::GateArrays & gates,
+							std::size_t num_qubits,
+							qiskit_toqm::RunTimings & timings) {
+	qiskit_toqm::ScopedTimer timer(timings.convertNanoseconds);
+	return gates.toGateOps(num_qubits);
+}
+
+py::list withStats(std::vector<std::unique_ptr<ToqmResult>> results,
+				   const std::vector<qiskit_toqm::RunTimings> & timings) {
+	py::list py_results;
+	for (std::size_t i = 0; i < results.size(); i++) {
+		py_results.append(qiskit_toqm::withStats(std::move(results[i]), timings[i]));
+	}
+	
+	return py_results;
+}
+
+using MapperClass = py::class_<qiskit_toqm::Mapper>;
+
+/**
+ * How each circuit representation accepted from Python is turned into the
+ * native gate list a Mapper routes, and what its argument is called.
+ */
+template<typename Gates>
+struct Input;
+
+template<>
+struct Input<std::vector<GateOp>> {
+	using BatchItem = std::vector<GateOp>;
+	
+	static const char * arg() { return "gates"; }
+	
+	static const std::vector<GateOp> & native(const std::vector<GateOp> & gate_ops, std::size_t,
+											  qiskit_toqm::RunTimings &, std::vector<GateOp> &) {
+		return gate_ops;
+	}
+	
+	static std::vector<GateOp> take(BatchItem item, std::size_t, qiskit_toqm::RunTimings &) {
+		return item;
+	}
+};
+
+// GateArrays are read through the buffer protocol, which needs the GIL,
+// so conversion happens before the GIL is released.
+template<>
+struct Input<qiskit_toqm::GateArrays> {
+	using BatchItem = const qiskit_toqm::GateArrays *;
+	
+	static const char * arg() { return "gates"; }
+	
+	static const std::vector<GateOp> & native(const qiskit_toqm::GateArrays & gates, std::size_t num_qubits,
+											  qiskit_toqm::RunTimings & timings, std::vector<GateOp> & storage) {
+		storage = convert(gates, num_qubits, timings);
+		return storage;
+	}
+	
+	static std::vector<GateOp> take(BatchItem item, std::size_t num_qubits, qiskit_toqm::RunTimings & timings) {
+		return convert(*item, num_qubits, timings);
+	}
+};
+
+// Prepared circuits are already native, so nothing is converted.
+template<>
+struct Input<qiskit_toqm::PreparedCircuit> {
+	static const char * arg() { return "circuit"; }
+	
+	static const std::vector<GateOp> & native(const qiskit_toqm::PreparedCircuit & circuit, std::size_t num_qubits,
+											  qiskit_toqm::RunTimings &, std::vector<GateOp> &) {
+		circuit.checkNumQubits(num_qubits);
+		return circuit.gateOps;
+	}
+};
+
+template<typename Gates>
+void defRun(MapperClass & mapper) {
+	mapper
+			.def("run", [](const qiskit_toqm::Mapper & self,
+						   const Gates & gates,
+						   std::size_t num_qubits,
+						   const CouplingMap & coupling_map) {
+				qiskit_toqm::RunTimings timings{};
+				std::vector<GateOp> storage{};
+				const auto & gate_ops = Input<Gates>::native(gates, num_qubits, timings, storage);
+				return qiskit_toqm::timedRun(timings, [&] {
+					return self.run(gate_ops, num_qubits, coupling_map);
+				});
+			}, py::arg(Input<Gates>::arg()), py::arg("num_qubits"), py::arg("coupling_map"))
+			.def("run", [](const qiskit_toqm::Mapper & self,
+						   const Gates & gates,
+						   std::size_t num_qubits,
+						   const CouplingMap & coupling_map,
+						   const std::vector<int> & init_qal) {
+				qiskit_toqm::RunTimings timings{};
+				std::vector<GateOp> storage{};
+				const auto & gate_ops = Input<Gates>::native(gates, num_qubits, timings, storage);
+				return qiskit_toqm::timedRun(timings, [&] {
+					return self.run(gate_ops, num_qubits, coupling_map, init_qal);
+				});
+			}, py::arg(Input<Gates>::arg()), py::arg("num_qubits"), py::arg("coupling_map"), py::arg("initial_layout"));
+}
+
+template<typename Gates>
+void defRunBatch(MapperClass & mapper) {
+	mapper.def("run_batch", [](const qiskit_toqm::Mapper & self,
+							   std::vector<typename Input<Gates>::BatchItem> gate_lists,
+							   const std::vector<std::size_t> & num_qubits_list,
+							   const CouplingMap & coupling_map,
+							   unsigned int num_threads,
+							   const qiskit_toqm::CancellationToken * cancellation_token) {
+		std::vector<qiskit_toqm::RunTimings> convert_timings(gate_lists.size());
+		std::vector<std::vector<GateOp>> gate_ops_list{};
+		gate_ops_list.reserve(gate_lists.size());
+		
+		for (std::size_t i = 0; i < gate_lists.size(); i++) {
+			gate_ops_list.emplace_back(Input<Gates>::take(std::move(gate_lists[i]), num_qubits_list.at(i),
+														  convert_timings[i]));
+		}
+		
+		std::vector<qiskit_toqm::RunTimings> timings{};
+		std::vector<std::unique_ptr<ToqmResult>> results{};
+		{
+			py::gil_scoped_release release;
+			results = self.runBatch(gate_ops_list, num_qubits_list, coupling_map, num_threads,
+									cancellation_token, &timings);
+		}
+		
+		for (std::size_t i = 0; i < timings.size(); i++) {
+			timings[i].convertNanoseconds = convert_timings[i].convertNanoseconds;
+		}
+		
+		return withStats(std::move(results), timings);
+	}, py::arg("gate_lists"), py::arg("num_qubits_list"), py::arg("coupling_map"), py::arg("num_threads") = 0,
+	   py::arg("cancellation_token") = nullptr);
+}
+
+// Prepared circuits know their number of qubits, and are routed without
+// copying their gate lists.
+template<>
+void defRunBatch<qiskit_toqm::PreparedCircuit>(MapperClass & mapper) {
+	mapper.def("run_batch", [](const qiskit_toqm::Mapper & self,
+							   const std::vector<const qiskit_toqm::PreparedCircuit *> & circuits,
+							   const CouplingMap & coupling_map,
+							   unsigned int num_threads,
+							   const qiskit_toqm::CancellationToken * cancellation_token) {
+		std::vector<qiskit_toqm::RunTimings> timings{};
+		std::vector<std::unique_ptr<ToqmResult>> results{};
+		{
+			py::gil_scoped_release release;
+			results = self.runBatch(circuits, coupling_map, num_threads, cancellation_token, &timings);
+		}
+		
+		return withStats(std::move(results), timings);
+	}, py::arg("circuits"), py::arg("coupling_map"), py::arg("num_threads") = 0,
+	   py::arg("cancellation_token") = nullptr);
+}
+
+template<typename Gates>
+void defRunPortfolio(MapperClass & mapper) {
+	mapper.def("run_portfolio", [](const qiskit_toqm::Mapper & self,
+								   const Gates & gates,
+								   std::size_t num_qubits,
+								   const CouplingMap & coupling_map,
+								   const std::vector<std::vector<int>> & init_qals,
+								   unsigned int num_threads,
+								   const qiskit_toqm::CancellationToken * cancellation_token) {
+		qiskit_toqm::RunTimings convert_timings{};
+		std::vector<GateOp> storage{};
+		const auto & gate_ops = Input<Gates>::native(gates, num_qubits, convert_timings, storage);
+		
+		qiskit_toqm::RunTimings timings{};
+		std::unique_ptr<ToqmResult> result{};
+		{
+			py::gil_scoped_release release;
+			result = self.runPortfolio(gate_ops, num_qubits, coupling_map, init_qals, num_threads,
+									   cancellation_token, &timings);
+		}
+		
+		timings.convertNanoseconds = convert_timings.convertNanoseconds;
+		return qiskit_toqm::withStats(std::move(result), timings);
+	}, py::arg(Input<Gates>::arg()), py::arg("num_qubits"), py::arg("coupling_map"), py::arg("initial_layouts"),
+	   py::arg("num_threads") = 0, py::arg("cancellation_token") = nullptr);
+}
+
+}
+
 PYBIND11_MODULE(_core, m) {
 	py::class_<CouplingMap>(m, "CouplingMap")
 			.def(py::init<unsigned int, std::set<std::pair<int, int>>>())
@@ -40,6 +236,40 @@ PYBIND11_MODULE(_core, m) {
 			.def_readwrite("control", &GateOp::control)
 			.def_readwrite("target", &GateOp::target);
 	
+	py::register_exception<qiskit_toqm::RoutingCancelled>(m, "RoutingCancelled");
+	
+	py::class_<qiskit_toqm::CancellationToken, std::shared_ptr<qiskit_toqm::CancellationToken>>(m, "CancellationToken")
+			.def(py::init<>())
+			.def("cancel", &qiskit_toqm::CancellationToken::cancel)
+			.def_property_readonly("cancelled", &qiskit_toqm::CancellationToken::isCancelled);
+	
+	py::class_<qiskit_toqm::GateArrays>(m, "GateArrays")
+			.def(py::init<qiskit_toqm::GateArrays::IndexArray,
+			              qiskit_toqm::GateArrays::IndexArray,
+			              qiskit_toqm::GateArrays::IndexArray,
+			              qiskit_toqm::GateArrays::IndexArray,
+			              std::vector<std::string>>(),
+			     // noconvert: arrays of another dtype or layout raise TypeError rather
+			     // than being copied.
+			     py::arg("uids").noconvert(), py::arg("types").noconvert(), py::arg("controls").noconvert(),
+			     py::arg("targets").noconvert(), py::arg("names"))
+			.def_readonly("uids", &qiskit_toqm::GateArrays::uids)
+			.def_readonly("types", &qiskit_toqm::GateArrays::types)
+			.def_readonly("controls", &qiskit_toqm::GateArrays::controls)
+			.def_readonly("targets", &qiskit_toqm::GateArrays::targets)
+			.def_readonly("names", &qiskit_toqm::GateArrays::names)
+			.def("__len__", &qiskit_toqm::GateArrays::size)
+			.def_static("from_nodes", &qiskit_toqm::GateArrays::fromNodes, py::arg("nodes"), py::arg("qubit_indices"),
+			            "Builds gate arrays from topologically ordered DAG op nodes, giving node i uid i.");
+	
+	py::class_<qiskit_toqm::PreparedCircuit>(m, "PreparedCircuit")
+			.def(py::init<std::vector<GateOp>, std::size_t>(), py::arg("gates"), py::arg("num_qubits"))
+			.def(py::init([](const qiskit_toqm::GateArrays & gates, std::size_t num_qubits) {
+				return qiskit_toqm::PreparedCircuit(gates.toGateOps(num_qubits), num_qubits);
+			}), py::arg("gates"), py::arg("num_qubits"))
+			.def_readonly("num_qubits", &qiskit_toqm::PreparedCircuit::numQubits)
+			.def("__len__", &qiskit_toqm::PreparedCircuit::size);
+	
 	py::class_<ScheduledGateOp>(m, "ScheduledGateOp")
 			.def_readwrite("gateOp", &ScheduledGateOp::gateOp)
 			.def_readwrite("physicalTarget", &ScheduledGateOp::physicalTarget)
@@ -47,7 +277,7 @@ PYBIND11_MODULE(_core, m) {
 			.def_readwrite("cycle", &ScheduledGateOp::cycle)
 			.def_readwrite("latency", &ScheduledGateOp::latency);
 	
-	py::class_<ToqmResult>(m, "ToqmResult")
+	py::class_<ToqmResult>(m, "ToqmResult", py::dynamic_attr())
 			.def_readonly("scheduledGates", &ToqmResult::scheduledGates)
 			.def_readwrite("remainingInQueue", &ToqmResult::remainingInQueue)
 			.def_readwrite("numPhysicalQubits", &ToqmResult::numPhysicalQubits)
@@ -57,7 +287,32 @@ PYBIND11_MODULE(_core, m) {
 			.def_readwrite("inferredLaq", &ToqmResult::inferredLaq)
 			.def_readwrite("idealCycles", &ToqmResult::idealCycles)
 			.def_readwrite("numPopped", &ToqmResult::numPopped)
-			.def_readwrite("filterStats", &ToqmResult::filterStats);
+			.def_readwrite("filterStats", &ToqmResult::filterStats)
+			.def("scheduled_gate_arrays", &qiskit_toqm::scheduledGateArrays,
+			     "Returns the schedule as a dict of NumPy arrays, viewing this result's memory where possible.")
+			.def("scheduled_node_order", &qiskit_toqm::scheduledNodeOrder,
+			     "Returns the original gates in schedule order and the positions of the swaps between them.")
+			.def("to_bytes", [](const ToqmResult & self) {
+				return py::bytes(qiskit_toqm::encodeResult(self));
+			}, "Returns the compact binary encoding of this result, excluding stats.")
+			.def_static("from_bytes", [](const std::string & data) {
+				return qiskit_toqm::decodeResult(data);
+			}, py::arg("data"))
+			// The encoded result is pickled with the instance dict, so stats
+			// survive the round trip.
+			.def(py::pickle(
+					[](const py::object & self) {
+						return py::make_tuple(py::bytes(qiskit_toqm::encodeResult(self.cast<const ToqmResult &>())),
+											  self.attr("__dict__"));
+					},
+					[](const py::tuple & state) {
+						if (state.size() != 2) {
+							throw std::invalid_argument("Invalid ToqmResult pickle state.");
+						}
+						
+						return std::make_pair(qiskit_toqm::decodeResult(state[0].cast<std::string>()),
+											  state[1].cast<py::dict>());
+					}));
 	
 	py::class_<LatencyDescription>(m, "LatencyDescription")
 			.def(py::init<int, int>())
@@ -68,7 +323,22 @@ PYBIND11_MODULE(_core, m) {
 			.def_readwrite("control", &LatencyDescription::control)
 			.def_readwrite("target", &LatencyDescription::target)
 			.def_readwrite("numQubits", &LatencyDescription::numQubits)
-			.def_readwrite("latency", &LatencyDescription::latency);
+			.def_readwrite("latency", &LatencyDescription::latency)
+			.def(py::pickle(
+					[](const LatencyDescription & self) {
+						return py::make_tuple(self.numQubits, self.type, self.control, self.target, self.latency);
+					},
+					[](const py::tuple & state) {
+						if (state.size() != 5) {
+							throw std::invalid_argument("Invalid LatencyDescription pickle state.");
+						}
+						
+						LatencyDescription description(state[0].cast<int>(), state[4].cast<int>());
+						description.type = state[1].cast<std::string>();
+						description.control = state[2].cast<int>();
+						description.target = state[3].cast<int>();
+						return description;
+					}));
 	
 	py::class_<Queue>(m, "Queue");
 	py::class_<DefaultQueue, Queue>(m, "DefaultQueue").def(py::init<>());
@@ -99,7 +369,8 @@ PYBIND11_MODULE(_core, m) {
 	py::class_<HashFilter, Filter>(m, "HashFilter").def(py::init<>());
 	py::class_<HashFilter2, Filter>(m, "HashFilter2").def(py::init<>());
 	
-	py::class_<ToqmMapper>(m, "ToqmMapper")
+	MapperClass mapper(m, "ToqmMapper");
+	mapper
 			.def(py::init([](const Queue& node_queue,
 							 const Expander& expander,
 							 const CostFunc& cost_func,
@@ -122,7 +393,7 @@ PYBIND11_MODULE(_core, m) {
 					fs.emplace_back(i.cast<Filter*>()->clone());
 				}
 				
-				return std::unique_ptr<ToqmMapper>(new ToqmMapper(
+				return std::unique_ptr<qiskit_toqm::Mapper>(new qiskit_toqm::Mapper(
 						node_queue,
 						expander.clone(),
 						cost_func.clone(),
@@ -131,10 +402,25 @@ PYBIND11_MODULE(_core, m) {
 						std::move(fs),
 						initial_search_cycles));
 			}))
-			.def("setRetainPopped", &ToqmMapper::setRetainPopped)
-			.def("setVerbose", &ToqmMapper::setVerbose)
-			.def("run", static_cast<std::unique_ptr<ToqmResult> (ToqmMapper::*)(const std::vector<GateOp> &, std::size_t, const CouplingMap &) const>(&ToqmMapper::run))
-			.def("run", static_cast<std::unique_ptr<ToqmResult> (ToqmMapper::*)(const std::vector<GateOp> &, std::size_t, const CouplingMap &, const std::vector<int> &) const>(&ToqmMapper::run));
+			.def("setRetainPopped", &qiskit_toqm::Mapper::setRetainPopped)
+			.def("setVerbose", &qiskit_toqm::Mapper::setVerbose);
+	
+	// The GIL is released only after the arguments have been converted to
+	// their native types, so the search itself never touches Python state.
+	// libtoqm does not guarantee that concurrent runs on one ToqmMapper are
+	// safe, so callers must not run a shared mapper from several threads at
+	// once; runBatch and runPortfolio build a ToqmMapper per worker instead.
+	defRun<std::vector<GateOp>>(mapper);
+	defRun<qiskit_toqm::GateArrays>(mapper);
+	defRun<qiskit_toqm::PreparedCircuit>(mapper);
+	
+	defRunBatch<std::vector<GateOp>>(mapper);
+	defRunBatch<qiskit_toqm::GateArrays>(mapper);
+	defRunBatch<qiskit_toqm::PreparedCircuit>(mapper);
+	
+	defRunPortfolio<std::vector<GateOp>>(mapper);
+	defRunPortfolio<qiskit_toqm::GateArrays>(mapper);
+	defRunPortfolio<qiskit_toqm::PreparedCircuit>(mapper);
 
 #ifdef VERSION_INFO
     m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
@@ -0,0 +1,216 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2022.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+import hashlib
+import os
+import tempfile
+import threading
+from collections import OrderedDict
+
+import numpy as np
+
+import qiskit_toqm.native as toqm
+
+# Bump whenever the key derivation or the on-disk layout changes, so that
+# entries written by older versions are never replayed. Keys also cover the
+# native module's version, so that routings found by an older search are never
+# replayed after an upgrade.
+_FORMAT_VERSION = 1
+
+_SCHEDULE_FIELDS = ("uid", "physicalControl", "physicalTarget", "cycle", "latency", "is_swap")
+
+
+def routing_key(gate_types, controls, targets, names, num_qubits, num_physical_qubits, edges, strategy_key):
+    """
+    Returns a canonical fingerprint of a routing problem.
+
+    Two problems with the same fingerprint are routed identically by the same
+    strategy and version of qiskit-toqm. Gate parameters are not part of the problem, so circuits that
+    differ only in e.g. rotation angles share a fingerprint.
+
+    Args:
+        gate_types (numpy.ndarray): The type id of each gate, in topological order.
+        controls (numpy.ndarray): The control qubit of each gate, or -1 for 1Q gates.
+        targets (numpy.ndarray): The target qubit of each gate.
+        names (List[str]): The gate name of each type id.
+        num_qubits (int): The number of virtual qubits used in the circuit.
+        num_physical_qubits (int): The number of physical qubits of the target.
+        edges (Iterable[Tuple[int, int]]): The directed couplings of the target.
+        strategy_key (str): Identifies the strategy and its configuration.
+
+    Returns:
+        str: A hex digest.
+    """
+    h = hashlib.sha256()
+    h.update(repr((_FORMAT_VERSION, toqm.__version__, num_qubits, num_physical_qubits, sorted(edges), list(names),
+                   strategy_key)).encode())
+    for array in (gate_types, controls, targets):
+        h.update(np.ascontiguousarray(array, dtype=np.int32).tobytes())
+
+    return h.hexdigest()
+
+
+class ToqmCachedResult:
+    """
+    The parts of a ``ToqmResult`` needed to replay a routing onto a circuit.
+
+    Provides the same ``scheduled_gate_arrays``, ``scheduled_node_order``,
+    ``inferredLaq``, ``inferredQal`` and ``numPhysicalQubits`` as the native
+    result it was taken from.
+    """
+
+    def __init__(self, schedule, inferred_laq, inferred_qal, num_physical_qubits):
+        self._schedule = schedule
+        self.inferredLaq = inferred_laq
+        self.inferredQal = inferred_qal
+        self.numPhysicalQubits = num_physical_qubits
+
+    @classmethod
+    def from_result(cls, result):
+        schedule = result.scheduled_gate_arrays()
+        return cls(
+            {field: np.array(schedule[field]) for field in _SCHEDULE_FIELDS},
+            list(result.inferredLaq),
+            list(result.inferredQal),
+            result.numPhysicalQubits
+        )
+
+    def scheduled_gate_arrays(self):
+        return self._schedule
+
+    def scheduled_node_order(self):
+        is_swap = self._schedule["is_swap"]
+        return {
+            "uid": self._schedule["uid"][~is_swap],
+            "physicalControl": self._schedule["physicalControl"][~is_swap],
+            "physicalTarget": self._schedule["physicalTarget"][~is_swap],
+            # Each swap comes before as many original gates as precede it in the schedule.
+            "swap_index": np.flatnonzero(is_swap) - np.arange(np.count_nonzero(is_swap)),
+            "swap_control": self._schedule["physicalControl"][is_swap],
+            "swap_target": self._schedule["physicalTarget"][is_swap],
+        }
+
+    def to_array(self):
+        """Packs this result into a single flat ``int32`` array."""
+        header = [_FORMAT_VERSION, len(self._schedule["uid"]), len(self.inferredLaq), len(self.inferredQal),
+                  self.numPhysicalQubits]
+        return np.concatenate(
+            [np.array(header, dtype=np.int32)]
+            + [np.asarray(self._schedule[field], dtype=np.int32) for field in _SCHEDULE_FIELDS]
+            + [np.array(self.inferredLaq, dtype=np.int32), np.array(self.inferredQal, dtype=np.int32)]
+        )
+
+    @classmethod
+    def from_array(cls, packed):
+        """
+        Unpacks a result packed by ``to_array``. The schedule arrays view
+        ``packed`` rather than copying it.
+
+        Raises:
+            ValueError: ``packed`` is not a packed result of this version.
+        """
+        if len(packed) < 5 or packed[0] != _FORMAT_VERSION:
+            raise ValueError("Not a cached TOQM result of this version.")
+
+        num_scheduled, num_laq, num_qal, num_physical_qubits = (int(x) for x in packed[1:5])
+        if len(packed) != 5 + len(_SCHEDULE_FIELDS) * num_scheduled + num_laq + num_qal:
+            raise ValueError("Truncated cached TOQM result.")
+
+        offset = 5
+        schedule = {}
+        for field in _SCHEDULE_FIELDS:
+            schedule[field] = packed[offset:offset + num_scheduled]
+            offset += num_scheduled
+
+        schedule["is_swap"] = schedule["is_swap"].astype(bool)
+        inferred_laq = packed[offset:offset + num_laq].tolist()
+        inferred_qal = packed[offset + num_laq:offset + num_laq + num_qal].tolist()
+
+        return cls(schedule, inferred_laq, inferred_qal, num_physical_qubits)
+
+
+class ToqmMemoryCache:
+    def __init__(self, maxsize=128):
+        """
+        An in-process cache of routing results that evicts the least
+        recently used entry once it holds ``maxsize`` entries.
+
+        May be shared by passes running on multiple threads.
+
+        Args:
+            maxsize (int): The maximum number of entries.
+        """
+        self.maxsize = maxsize
+        self._entries = OrderedDict()
+        self._lock = threading.Lock()
+
+    def get(self, key):
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is not None:
+                self._entries.move_to_end(key)
+
+            return entry
+
+    def put(self, key, result):
+        with self._lock:
+            self._entries[key] = result
+            self._entries.move_to_end(key)
+            while len(self._entries) > self.maxsize:
+                self._entries.popitem(last=False)
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __getstate__(self):
+        # Locks cannot be pickled, so the copy gets a lock of its own.
+        with self._lock:
+            return self.maxsize, OrderedDict(self._entries)
+
+    def __setstate__(self, state):
+        self.maxsize, self._entries = state
+        self._lock = threading.Lock()
+
+
+class ToqmDiskCache:
+    def __init__(self, directory):
+        """
+        A cache of routing results stored as one ``.npy`` file per entry.
+
+        Entries are written to a temporary file and then renamed into place,
+        so the directory may be shared by every process on a host, and are
+        memory-mapped when read.
+
+        Args:
+            directory (str): The directory holding the entries. Created if missing.
+        """
+        self.directory = directory
+        os.makedirs(directory, exist_ok=True)
+
+    def _path(self, key):
+        return os.path.join(self.directory, f"{key}.npy")
+
+    def get(self, key):
+        try:
+            return ToqmCachedResult.from_array(np.load(self._path(key), mmap_mode="r"))
+        except (OSError, ValueError):
+            # Missing, or written by another version.
+            return None
+
+    def put(self, key, result):
+        fd, tmp_path = tempfile.mkstemp(dir=self.directory, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                np.save(f, result.to_array())
+            os.replace(tmp_path, self._path(key))
+        except BaseException:
+            os.unlink(tmp_path)
+            raise
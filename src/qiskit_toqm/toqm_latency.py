@@ -14,9 +14,52 @@ import qiskit
 from qiskit.transpiler import TranspilerError
 import qiskit_toqm.native as toqm
 
+import threading
+from collections import OrderedDict
 from itertools import chain
 
 
+# Swap durations already calculated for recently used targets, keyed by
+# everything the calculation reads from the target.
+_target_swap_durations = OrderedDict()
+_target_swap_durations_lock = threading.Lock()
+_TARGET_SWAP_DURATIONS_SIZE = 8
+
+
+def _swap_durations_for_target(target, instruction_durations):
+    """
+    Memoized ``_calc_swap_durations`` for a transpiler target.
+
+    Entries are keyed by the target's durations, couplings and operations, so
+    a target that changes after its first use is recalculated.
+    """
+    coupling_map = target.build_coupling_map()
+    key = (
+        instruction_durations.dt,
+        tuple(sorted(instruction_durations.duration_by_name.items())),
+        tuple(sorted(instruction_durations.duration_by_name_qubits.items())),
+        tuple(sorted(coupling_map.get_edges())),
+        tuple(sorted(target.operation_names))
+    )
+
+    with _target_swap_durations_lock:
+        durations = _target_swap_durations.get(key)
+        if durations is not None:
+            _target_swap_durations.move_to_end(key)
+            return durations
+
+    durations = list(_calc_swap_durations(
+        coupling_map, instruction_durations, target.operation_names, None, target))
+
+    with _target_swap_durations_lock:
+        _target_swap_durations[key] = durations
+        _target_swap_durations.move_to_end(key)
+        while len(_target_swap_durations) > _TARGET_SWAP_DURATIONS_SIZE:
+            _target_swap_durations.popitem(last=False)
+
+    return durations
+
+
 def _calc_swap_durations(coupling_map, instruction_durations, basis_gates, backend_properties, target):
     """Calculates the durations of swap gates between each coupling on the target."""
     # Filter for couplings that don't already have a native swap.
@@ -35,32 +78,63 @@ def _calc_swap_durations(coupling_map, instruction_durations, basis_gates, backe
             "'instruction_durations' has durations for all swap gates."
         )
 
+    unit = "dt" if instruction_durations.dt else "s"
+
+    # The instructions with durations on each tuple of qubits.
+    ops_by_qubits = {}
+    for op_name, qubits in instruction_durations.duration_by_name_qubits:
+        ops_by_qubits.setdefault(qubits, set()).add(op_name)
+
+    def decomposition_class(s, t):
+        # Couplings that offer the same instructions in each direction and on
+        # each qubit decompose a swap into the same instruction sequence.
+        return tuple(
+            tuple(sorted(ops_by_qubits.get(qubits, ())))
+            for qubits in ((s, t), (t, s), (s,), (t,))
+        )
+
+    classes = {}
+    for pair in couplings:
+        classes.setdefault(decomposition_class(*pair), []).append(pair)
+
     def gen_swap_circuit(s, t):
         # Generates a circuit with a single swap gate between src and tgt
         c = qiskit.QuantumCircuit(coupling_map.size())
         c.swap(s, t)
         return c
 
-    # Batch transpile generated swap circuits
+    # Transpile a single swap per class (rather than per coupling), and keep
+    # its instruction sequence with qubits relative to the swapped pair.
+    representatives = [pairs[0] for pairs in classes.values()]
     swap_circuits = qiskit.transpile(
-        [gen_swap_circuit(*pair) for pair in couplings],
+        [gen_swap_circuit(*pair) for pair in representatives],
         basis_gates=basis_gates,
         coupling_map=coupling_map,
         backend_properties=backend_properties if target is None else None,
         instruction_durations=instruction_durations,
         target=target,
         optimization_level=0,
-        layout_method="trivial",
-        scheduling_method="asap"
+        layout_method="trivial"
     )
 
-    for (src, tgt), qc in zip(couplings, swap_circuits):
-        if instruction_durations.dt is None and qc.unit == "dt":
-            # TODO: should be able to convert by looking up an op in both
-            raise TranspilerError("Incompatible units.")
+    for (src, tgt), qc, pairs in zip(representatives, swap_circuits, classes.values()):
+        position = {src: 0, tgt: 1}
+        template = [
+            (inst.operation.name, [position[qc.find_bit(q).index] for q in inst.qubits])
+            for inst in qc.data
+            if inst.operation.name not in ("barrier", "delay")
+        ]
 
-        duration = qc.qubit_duration(src, tgt)
-        yield src, tgt, duration
+        # Schedule the decomposition ASAP on each coupling of the class.
+        for pair in pairs:
+            available = [0, 0]
+            for op_name, positions in template:
+                start = max(available[p] for p in positions)
+                end = start + instruction_durations.get(op_name, [pair[p] for p in positions], unit)
+                for p in positions:
+                    available[p] = end
+
+            yield pair[0], pair[1], max(available)
 
 
 def latencies_from_target(
@@ -108,7 +182,11 @@ def latencies_from_target(
 
     unit = "dt" if instruction_durations.dt else "s"
 
-    swap_durations = list(_calc_swap_durations(coupling_map, instruction_durations, basis_gates, backend_properties, target))
+    if target is not None:
+        swap_durations = _swap_durations_for_target(target, instruction_durations)
+    else:
+        swap_durations = list(_calc_swap_durations(
+            coupling_map, instruction_durations, basis_gates, backend_properties, target))
     default_op_durations = [
         (op_name, instruction_durations.get(op_name, [], unit))
         for op_name in instruction_durations.duration_by_name
@@ -10,10 +10,66 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 
+import threading
+
 import qiskit_toqm.native as toqm
 
 
-class ToqmHeuristicStrategy:
+def _latency_key(latency_descriptions):
+    """Returns a canonical, hashable form of the given latency descriptions."""
+    return tuple(sorted((d.type, d.control, d.target, d.numQubits, d.latency) for d in latency_descriptions))
+
+
+def _qubit_independent(latency_descriptions):
+    """Returns whether none of the given latency descriptions is specific to a qubit."""
+    return all(d.control < 0 and d.target < 0 for d in latency_descriptions)
+
+
+class ToqmStrategy:
+    """
+    Base class of the built-in strategies.
+
+    ``ToqmSwap`` passes gates to these strategies as ``toqm.GateArrays``,
+    which their native mappers accept directly.
+
+    A strategy is pickled as the arguments it was constructed with, since its
+    native mappers cannot be pickled, and rebuilt from them. Subclasses store
+    their constructor arguments in ``self._args``.
+
+    Note:
+        The GIL is released while the native search runs, so a single strategy
+        instance may be called concurrently from multiple threads, e.g. from a
+        ``concurrent.futures.ThreadPoolExecutor``. libtoqm does not guarantee
+        that concurrent runs on one native mapper are safe, so each thread
+        routes with native mappers of its own, built by ``_build_mappers`` on
+        its first call.
+    """
+
+    accepts_gate_arrays = True
+
+    def __init__(self):
+        self._local = threading.local()
+
+    def _build_mappers(self):
+        """Returns a new tuple of the native mappers this strategy routes with."""
+        return ()
+
+    def _thread_mappers(self):
+        """Returns the calling thread's native mappers, building them on first use."""
+        mappers = getattr(self._local, "mappers", None)
+        if mappers is None:
+            mappers = self._local.mappers = self._build_mappers()
+
+        return mappers
+
+    def __getstate__(self):
+        return self._args
+
+    def __setstate__(self, state):
+        self.__init__(*state)
+
+
+class ToqmHeuristicStrategy(ToqmStrategy):
     def __init__(self, latency_descriptions, top_k, queue_target, queue_max, retain_popped=1):
         """
         Constructs a TOQM strategy that aims to minimize overall circuit duration.
@@ -34,36 +90,61 @@ class ToqmHeuristicStrategy:
         Raises:
             RuntimeError: No routing was found.
         """
+        super().__init__()
+        latency_descriptions = list(latency_descriptions)
+        self._args = (latency_descriptions, top_k, queue_target, queue_max, retain_popped)
+
+        # The mapper of the constructing thread.
+        self.mapper, = self._thread_mappers()
+
+        # Identifies this configuration to ToqmSwap's routing cache.
+        self.cache_key = repr((type(self).__name__, _latency_key(latency_descriptions), top_k, queue_target,
+                               queue_max, retain_popped))
+
+        # Whether a subset of the device may be routed on a relabeled coupling map.
+        self.qubit_independent_latencies = _qubit_independent(latency_descriptions)
+
+    def _build_mappers(self):
+        latency_descriptions, top_k, queue_target, queue_max, retain_popped = self._args
+
         # The following defaults are based on:
         # https://github.com/time-optimal-qmapper/TOQM/blob/main/code/README.txt
-        self.mapper = toqm.ToqmMapper(
+        mapper = toqm.ToqmMapper(
             toqm.TrimSlowNodes(queue_max, queue_target),
             toqm.GreedyTopK(top_k),
             toqm.CXFrontier(),
-            toqm.Table(list(latency_descriptions)),
+            toqm.Table(latency_descriptions),
             [toqm.GreedyMapper()],
             [],
             0
         )
 
-        self.mapper.setRetainPopped(retain_popped)
+        mapper.setRetainPopped(retain_popped)
+        return mapper,
 
-    def __call__(self, gates, num_qubits, coupling_map):
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
         """
         Run native ToqmMapper and return the native result.
 
         Args:
-            gates (List[toqm.GateOp]): The topologically ordered list of gate operations.
+            gates (Union[List[toqm.GateOp], toqm.GateArrays, toqm.PreparedCircuit]): The topologically ordered
+            list of gate operations.
             num_qubits (int): The number of virtual qubits used in the circuit.
             coupling_map (toqm.CouplingMap): The coupling map of the target.
+            initial_layout (Optional[List[int]]): The logical qubit initially placed on each
+            physical qubit, or -1 if none. If not specified, the layout is chosen by the mapper.
 
         Returns:
             toqm.ToqmResult: The native result.
         """
-        return self.mapper.run(gates, num_qubits, coupling_map)
+        mapper, = self._thread_mappers()
+        if initial_layout is not None:
+            return mapper.run(gates, num_qubits, coupling_map, initial_layout)
 
+        return mapper.run(gates, num_qubits, coupling_map)
 
-class ToqmOptimalStrategy:
+
+class ToqmOptimalStrategy(ToqmStrategy):
     def __init__(self, latency_descriptions, perform_layout=True, no_swaps=False):
         """
         Constructs a TOQM strategy that finds an optimal (minimal) routing
@@ -79,28 +160,59 @@ class ToqmOptimalStrategy:
         Raises:
             RuntimeError: No routing was found.
         """
+        super().__init__()
+        latency_descriptions = list(latency_descriptions)
+        self._args = (latency_descriptions, perform_layout, no_swaps)
+
+        # The mappers of the constructing thread.
+        self.mapper, self.seeded_mapper = self._thread_mappers()
+
+        # Identifies this configuration to ToqmSwap's routing cache.
+        self.cache_key = repr((type(self).__name__, _latency_key(latency_descriptions), perform_layout, no_swaps))
+
+        # Whether a subset of the device may be routed on a relabeled coupling map.
+        self.qubit_independent_latencies = _qubit_independent(latency_descriptions)
+
+    def _build_mappers(self):
+        latency_descriptions, perform_layout, no_swaps = self._args
+
         # The following defaults are based on:
         # https://github.com/time-optimal-qmapper/TOQM/blob/main/code/README.txt
-        self.mapper = toqm.ToqmMapper(
-            toqm.DefaultQueue(),
-            toqm.NoSwaps() if no_swaps else toqm.DefaultExpander(),
-            toqm.CXFrontier(),
-            toqm.Table(latency_descriptions),
-            [],
-            [toqm.HashFilter(), toqm.HashFilter2()],
-            -1 if perform_layout else 0
-        )
-
-    def __call__(self, gates, num_qubits, coupling_map):
+        def make_mapper(initial_search_cycles):
+            return toqm.ToqmMapper(
+                toqm.DefaultQueue(),
+                toqm.NoSwaps() if no_swaps else toqm.DefaultExpander(),
+                toqm.CXFrontier(),
+                toqm.Table(latency_descriptions),
+                [],
+                [toqm.HashFilter(), toqm.HashFilter2()],
+                initial_search_cycles
+            )
+
+        mapper = make_mapper(-1 if perform_layout else 0)
+
+        # Searching for a layout would permute a given initial layout, so runs
+        # seeded with one never search.
+        return mapper, make_mapper(0) if perform_layout else mapper
+
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
         """
         Run native ToqmMapper and return the native result.
 
         Args:
-            gates (List[toqm.GateOp]): The topologically ordered list of gate operations.
+            gates (Union[List[toqm.GateOp], toqm.GateArrays, toqm.PreparedCircuit]): The topologically ordered
+            list of gate operations.
             num_qubits (int): The number of virtual qubits used in the circuit.
             coupling_map (toqm.CouplingMap): The coupling map of the target.
+            initial_layout (Optional[List[int]]): The logical qubit initially placed on each
+            physical qubit, or -1 if none. If specified, the search starts from and keeps this
+            layout. Otherwise, the layout is chosen by the mapper.
 
         Returns:
             toqm.ToqmResult: The native result.
         """
-        return self.mapper.run(gates, num_qubits, coupling_map)
+        mapper, seeded_mapper = self._thread_mappers()
+        if initial_layout is not None:
+            return seeded_mapper.run(gates, num_qubits, coupling_map, initial_layout)
+
+        return mapper.run(gates, num_qubits, coupling_map)
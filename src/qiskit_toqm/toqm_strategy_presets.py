@@ -10,7 +10,9 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 
+import qiskit_toqm.native as toqm
 from qiskit_toqm import ToqmHeuristicStrategy, ToqmOptimalStrategy
+from qiskit_toqm.toqm_strategy import ToqmStrategy
 
 # NOTE: currently, the heuristic mappers use the hard-coded latencies of 1, 2 and 6
 # for 1Q, 2Q and SWAP gates, respectively. This is because when gate-specific latencies
@@ -19,7 +21,20 @@ from qiskit_toqm import ToqmHeuristicStrategy, ToqmOptimalStrategy
 from qiskit_toqm import latencies_from_simple
 
 
-class ToqmStrategyO0:
+class _ToqmPresetStrategy(ToqmStrategy):
+    """
+    Base class of the presets, which route with ``latencies_from_simple`` rather
+    than the latencies they are given.
+    """
+
+    # The given latencies are not used, so they are neither evaluated nor pickled.
+    _args = ([],)
+
+    # Simple latencies do not depend on the qubits.
+    qubit_independent_latencies = True
+
+
+class ToqmStrategyO0(_ToqmPresetStrategy):
     def __init__(self, latency_descriptions):
         """
         Constructs a TOQM strategy that executes as fast as possible.
@@ -36,12 +51,13 @@ class ToqmStrategyO0:
             queue_target=3000,
             queue_max=5000
         )
+        self.cache_key = repr((type(self).__name__, self.heuristic_strategy.cache_key))
 
-    def __call__(self, gates, num_qubits, coupling_map):
-        return self.heuristic_strategy(gates, num_qubits, coupling_map)
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
+        return self.heuristic_strategy(gates, num_qubits, coupling_map, initial_layout)
 
 
-class ToqmStrategyO1:
+class ToqmStrategyO1(_ToqmPresetStrategy):
     def __init__(self, latency_descriptions):
         """
         Constructs a TOQM strategy that should produce a circuit with
@@ -65,17 +81,18 @@ class ToqmStrategyO1:
             queue_target=400,
             queue_max=800
         )
+        self.cache_key = repr((type(self).__name__, self.optimal_strategy.cache_key, self.heuristic_strategy.cache_key))
 
-    def __call__(self, gates, num_qubits, coupling_map):
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
         if coupling_map.numPhysicalQubits < 6:
             strategy = self.optimal_strategy
         else:
             strategy = self.heuristic_strategy
 
-        return strategy(gates, num_qubits, coupling_map)
+        return strategy(gates, num_qubits, coupling_map, initial_layout)
 
 
-class ToqmStrategyO2:
+class ToqmStrategyO2(_ToqmPresetStrategy):
     def __init__(self, latency_descriptions):
         """
         Constructs a TOQM strategy that should produce a circuit with
@@ -99,17 +116,18 @@ class ToqmStrategyO2:
             queue_target=400,
             queue_max=100
         )
+        self.cache_key = repr((type(self).__name__, self.optimal_strategy.cache_key, self.heuristic_strategy.cache_key))
 
-    def __call__(self, gates, num_qubits, coupling_map):
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
         if coupling_map.numPhysicalQubits < 6:
             strategy = self.optimal_strategy
         else:
             strategy = self.heuristic_strategy
 
-        return strategy(gates, num_qubits, coupling_map)
+        return strategy(gates, num_qubits, coupling_map, initial_layout)
 
 
-class ToqmStrategyO3:
+class ToqmStrategyO3(_ToqmPresetStrategy):
     def __init__(self, latency_descriptions):
         """
         Constructs a TOQM strategy that should produce a circuit with
@@ -138,15 +156,21 @@ class ToqmStrategyO3:
             queue_target=3600,
             queue_max=4800
         )
+        self.cache_key = repr((type(self).__name__, self.optimal_strategy.cache_key,
+                               self.optimal_strategy_no_swaps.cache_key, self.heuristic_strategy.cache_key))
 
-    def __call__(self, gates, num_qubits, coupling_map):
+    def __call__(self, gates, num_qubits, coupling_map, initial_layout=None):
         if coupling_map.numPhysicalQubits < 6:
+            # Both strategies may route the same input, so convert it only once.
+            if not isinstance(gates, toqm.PreparedCircuit):
+                gates = toqm.PreparedCircuit(gates, num_qubits)
+
             # try no swaps first
             try:
-                return self.optimal_strategy_no_swaps(gates, num_qubits, coupling_map)
+                return self.optimal_strategy_no_swaps(gates, num_qubits, coupling_map, initial_layout)
             except RuntimeError:
                 strategy = self.optimal_strategy
         else:
             strategy = self.heuristic_strategy
 
-        return strategy(gates, num_qubits, coupling_map)
+        return strategy(gates, num_qubits, coupling_map, initial_layout)
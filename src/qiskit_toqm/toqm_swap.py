@@ -10,8 +10,14 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 import logging
+import os
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
 
 import qiskit_toqm.native as toqm
+from qiskit_toqm.toqm_cache import ToqmCachedResult, routing_key
 
 from qiskit.circuit.library.standard_gates import SwapGate
 from qiskit.dagcircuit import DAGCircuit
@@ -22,6 +28,97 @@ from qiskit.transpiler.exceptions import TranspilerError
 logger = logging.getLogger(__name__)
 
 
+def _gate_layers(controls, targets, num_qubits):
+    """
+    Returns the ASAP layer of each gate of a topologically ordered gate list.
+
+    Args:
+        controls (numpy.ndarray): The control qubit of each gate, or -1 for 1Q gates.
+        targets (numpy.ndarray): The target qubit of each gate.
+        num_qubits (int): The number of qubits the gates act on.
+    """
+    depth = [0] * num_qubits
+    layers = np.empty(len(targets), dtype=np.int64)
+    for i, (control, target) in enumerate(zip(controls.tolist(), targets.tolist())):
+        layer = depth[target] if control < 0 else max(depth[control], depth[target])
+        layers[i] = layer
+        depth[target] = layer + 1
+        if control >= 0:
+            depth[control] = layer + 1
+
+    return layers
+
+
+def _interaction_components(controls, targets, num_qubits):
+    """
+    Returns the qubits of each connected component of the interaction graph
+    that contains at least one 2Q gate, each sorted, largest component first.
+
+    Args:
+        controls (numpy.ndarray): The control qubit of each gate, or -1 for 1Q gates.
+        targets (numpy.ndarray): The target qubit of each gate.
+        num_qubits (int): The number of qubits the gates act on.
+    """
+    parent = list(range(num_qubits))
+
+    def find(q):
+        while parent[q] != q:
+            parent[q] = parent[parent[q]]
+            q = parent[q]
+        return q
+
+    two_qubit = controls >= 0
+    for control, target in zip(controls[two_qubit].tolist(), targets[two_qubit].tolist()):
+        parent[find(control)] = find(target)
+
+    components = {}
+    for q in np.unique(np.concatenate([controls[two_qubit], targets[two_qubit]])).tolist():
+        components.setdefault(find(q), []).append(q)
+
+    return sorted(components.values(), key=len, reverse=True)
+
+
+def _disjoint_regions(sizes, num_physical, edges):
+    """
+    Finds a connected region of physical qubits of each of the given sizes,
+    with no qubit in more than one region, by growing each region breadth
+    first from the free qubit with the fewest free neighbors.
+
+    Returns:
+        Optional[List[List[int]]]: The physical qubits of each region, or
+        None if the free qubits became too fragmented to place a region.
+    """
+    neighbors = [set() for _ in range(num_physical)]
+    for a, b in edges:
+        neighbors[a].add(b)
+        neighbors[b].add(a)
+
+    free = set(range(num_physical))
+    regions = []
+    for size in sizes:
+        seeds = sorted(free, key=lambda p: (len(neighbors[p] & free), p))
+        for seed in seeds:
+            region = [seed]
+            seen = {seed}
+            queue = deque([seed])
+            while queue and len(region) < size:
+                for p in sorted(neighbors[queue.popleft()] & free):
+                    if p not in seen and len(region) < size:
+                        seen.add(p)
+                        region.append(p)
+                        queue.append(p)
+
+            if len(region) == size:
+                break
+        else:
+            return None
+
+        free -= seen
+        regions.append(region)
+
+    return regions
+
+
 class ToqmSwap(TransformationPass):
     r"""Map input circuit onto a backend topology via insertion of SWAPs.
     Implementation of the SWAP-based approach from Time-Optimal Qubit
@@ -37,7 +134,11 @@ class ToqmSwap(TransformationPass):
     def __init__(
             self,
             coupling_map,
-            strategy):
+            strategy,
+            window_layers=None,
+            cache=None,
+            partition=False,
+            max_workers=None):
         """
         ToqmSwap initializer.
 
@@ -45,7 +146,35 @@ class ToqmSwap(TransformationPass):
             coupling_map (CouplingMap): CouplingMap of the target backend.
             strategy (typing.Callable[[List[toqm.GateOp], int, toqm.CouplingMap], toqm.ToqmResult]):
                 A callable responsible for running the native ``ToqmMapper`` and
-                returning a native ``ToqmResult``.
+                returning a native ``ToqmResult``. It receives the gates as a list
+                of ``toqm.GateOp``, or as a ``toqm.GateArrays`` (which skips building
+                a native object per gate) if it has an ``accepts_gate_arrays``
+                attribute set to true, as subclasses of ``ToqmStrategy`` do. If
+                ``window_layers`` is set, it must also accept an initial layout
+                (physical to logical qubit indices) as a fourth argument.
+            window_layers (Optional[int]): If set, the circuit is routed in
+                consecutive windows of this many layers, each starting from the
+                final layout of the previous window. This bounds the search to
+                one window at a time, at the cost of not optimizing across
+                window boundaries.
+            cache (Optional[Union[ToqmMemoryCache, ToqmDiskCache]]): If set, routing
+                results are stored in and replayed from this cache, keyed by the
+                circuit's gate structure (ignoring gate parameters), the coupling
+                map and ``strategy.cache_key``. On a hit no search is run, and
+                ``toqm_result`` is a ``ToqmCachedResult``. Cannot be combined
+                with ``window_layers``.
+            partition (bool): If true, and the circuit's 2Q gates split into
+                several qubit-disjoint components, each component is routed
+                concurrently on its own connected region of the coupling map,
+                and the schedules are merged by cycle. Regions never overlap,
+                so this can route worse than a joint search. Components are
+                routed on relabeled sub-coupling maps, so the strategy must have
+                a ``qubit_independent_latencies`` attribute set to true, as the
+                built-in strategies do when given latencies that do not depend
+                on the qubits (e.g. ``latencies_from_simple``). Cannot be
+                combined with ``window_layers``.
+            max_workers (Optional[int]): The maximum number of components routed
+                at once when ``partition`` is set. Defaults to the number of CPUs.
         """
         super().__init__()
 
@@ -58,9 +187,32 @@ class ToqmSwap(TransformationPass):
         if coupling_map.size() > 127:
             raise TranspilerError("ToqmSwap currently supports a max of 127 qubits.")
 
+        if window_layers is not None and window_layers < 1:
+            raise TranspilerError("window_layers must be at least 1.")
+
+        if partition and window_layers is not None:
+            raise TranspilerError("partition cannot be combined with window_layers.")
+
+        if partition and not getattr(strategy, "qubit_independent_latencies", False):
+            raise TranspilerError("partition requires a strategy with qubit_independent_latencies.")
+
+        if cache is not None:
+            if window_layers is not None:
+                raise TranspilerError("cache cannot be combined with window_layers.")
+
+            if getattr(strategy, "cache_key", None) is None:
+                raise TranspilerError("Only strategies that define a cache_key can be cached.")
+
         self.coupling_map = coupling_map
+        # Converted once per pass, rather than on every run.
+        self._couplings = toqm.CouplingMap(coupling_map.size(), set(coupling_map.get_edges()))
         self.toqm_strategy = strategy
+        self.window_layers = window_layers
+        self.cache = cache
+        self.partition = partition
+        self.max_workers = max_workers
         self.toqm_result = None
+        self.toqm_results = []
 
     def run(self, dag: DAGCircuit):
         """Run the ToqmSwap pass on `dag`.
@@ -83,52 +235,273 @@ class ToqmSwap(TransformationPass):
 
         reg = dag.qregs["q"]
 
-        # Generate UIDs for each gate node from the original circuit so we can
-        # look them up later when rebuilding the circuit.
-        # Note: this is still sorted by topological order from above.
-        uid_to_op_node = {uid: op for uid, op in enumerate(dag.topological_op_nodes())}
+        # The UID of each gate node from the original circuit is its index in
+        # topological order, so we can look them up later when rebuilding the
+        # circuit.
+        op_nodes = list(dag.topological_op_nodes())
 
-        # Create TOQM topological gate list
-        def gates():
-            for uid, node in uid_to_op_node.items():
-                if len(node.qargs) == 2:
-                    yield toqm.GateOp(uid, node.op.name, reg.index(node.qargs[0]), reg.index(node.qargs[1]))
-                elif len(node.qargs) == 1:
-                    yield toqm.GateOp(uid, node.op.name, reg.index(node.qargs[0]))
-                else:
-                    raise TranspilerError(f"ToqmSwap only works with 1q and 2q gates! "
-                                          f"Bad gate: {node.op.name} {node.qargs}")
+        # Create TOQM topological gate list as columnar arrays so that no
+        # native object needs to be created per gate.
+        try:
+            gate_arrays = toqm.GateArrays.from_nodes(op_nodes, {bit: i for i, bit in enumerate(reg)})
+        except ValueError as e:
+            raise TranspilerError(str(e)) from e
 
-        gate_ops = list(gates())
-        edges = {e for e in self.coupling_map.get_edges()}
-        couplings = toqm.CouplingMap(self.coupling_map.size(), edges)
+        num_gates = len(op_nodes)
+        gate_types = gate_arrays.types
+        controls = gate_arrays.controls
+        targets = gate_arrays.targets
 
-        self.toqm_result = self.toqm_strategy(gate_ops, dag.num_qubits(), couplings)
+        couplings = self._couplings
 
         # Preserve input DAG's name, regs, wire_map, etc. but replace the graph.
         mapped_dag = dag.copy_empty_like()
 
-        for g in self.toqm_result.scheduledGates:
-            if g.gateOp.type.lower() == "swap":
-                mapped_dag.apply_operation_back(SwapGate(), qargs=[reg[g.physicalControl], reg[g.physicalTarget]])
-                continue
+        if self.partition and self._run_partitioned(mapped_dag, reg, op_nodes, gate_arrays, dag.num_qubits()):
+            return mapped_dag
+
+        if self.window_layers is None or num_gates == 0:
+            self.toqm_result = self._route_cached(gate_arrays, dag.num_qubits(), couplings)
+            self.toqm_results = [self.toqm_result]
+            self._apply_schedule(mapped_dag, reg, op_nodes, self.toqm_result)
+            self._update_layout(self.toqm_result.inferredLaq, self.toqm_result.inferredQal)
+        else:
+            self._run_windowed(mapped_dag, reg, op_nodes, gate_types, controls, targets, gate_arrays.names,
+                               dag.num_qubits(), couplings)
+
+        return mapped_dag
+
+    def _call_strategy(self, gate_arrays, num_qubits, couplings, *initial_layout):
+        """
+        Calls the strategy with ``gate_arrays``, or with the equivalent list of
+        ``toqm.GateOp`` for strategies that do not set ``accepts_gate_arrays``.
+        """
+        gate_ops = gate_arrays
+        if not getattr(self.toqm_strategy, "accepts_gate_arrays", False):
+            names = gate_arrays.names
+            gate_ops = [
+                toqm.GateOp(uid, names[t], c, tg) if c >= 0 else toqm.GateOp(uid, names[t], tg)
+                for uid, t, c, tg in zip(gate_arrays.uids.tolist(), gate_arrays.types.tolist(),
+                                         gate_arrays.controls.tolist(), gate_arrays.targets.tolist())
+            ]
+
+        return self.toqm_strategy(gate_ops, num_qubits, couplings, *initial_layout)
+
+    def _route_cached(self, gate_ops, num_qubits, couplings):
+        """Runs the strategy, unless the cache already holds its result."""
+        if self.cache is None:
+            return self._call_strategy(gate_ops, num_qubits, couplings)
 
-            original_op = uid_to_op_node[g.gateOp.uid]
-            if g.physicalControl >= 0:
-                mapped_dag.apply_operation_back(original_op.op, cargs=original_op.cargs, qargs=[
-                    reg[g.physicalControl],
-                    reg[g.physicalTarget]
-                ])
+        key = routing_key(gate_ops.types, gate_ops.controls, gate_ops.targets, gate_ops.names, num_qubits,
+                          couplings.numPhysicalQubits, couplings.edges, self.toqm_strategy.cache_key)
+
+        result = self.cache.get(key)
+        if result is not None:
+            logger.debug("Replaying cached TOQM result %s.", key)
+            return result
+
+        result = self._call_strategy(gate_ops, num_qubits, couplings)
+        self.cache.put(key, ToqmCachedResult.from_result(result))
+        return result
+
+    def _run_partitioned(self, mapped_dag, reg, op_nodes, gate_arrays, num_qubits):
+        """
+        Routes each interaction component on its own region of the coupling
+        map. Returns False, without routing, if the circuit has fewer than two
+        components or they cannot be placed on disjoint regions.
+        """
+        controls = gate_arrays.controls
+        targets = gate_arrays.targets
+        components = _interaction_components(controls, targets, num_qubits)
+        if len(components) < 2:
+            return False
+
+        num_physical = self.coupling_map.size()
+        edges = self.coupling_map.get_edges()
+        regions = _disjoint_regions([len(c) for c in components], num_physical, edges)
+        if regions is None:
+            logger.debug("Could not place %d interaction components on disjoint regions.", len(components))
+            return False
+
+        # The component of each logical qubit, or -1 for qubits touched by 1Q gates only.
+        component_of = np.full(num_qubits, -1, dtype=np.int64)
+        for i, component in enumerate(components):
+            component_of[component] = i
+
+        gate_component = component_of[targets]
+
+        def route(i):
+            local = {q: j for j, q in enumerate(components[i])}
+            position = {p: j for j, p in enumerate(regions[i])}
+            uids = np.flatnonzero(gate_component == i)
+            gate_ops = toqm.GateArrays(
+                np.arange(len(uids), dtype=np.int32),
+                gate_arrays.types[uids],
+                np.array([local.get(q, -1) for q in controls[uids].tolist()], dtype=np.int32),
+                np.array([local[q] for q in targets[uids].tolist()], dtype=np.int32),
+                gate_arrays.names
+            )
+
+            couplings = toqm.CouplingMap(len(regions[i]), set(
+                (position[a], position[b]) for a, b in edges if a in position and b in position))
+
+            return uids, self._route_cached(gate_ops, len(components[i]), couplings)
+
+        max_workers = min(len(components), self.max_workers or os.cpu_count() or 1)
+        with ThreadPoolExecutor(max_workers=max_workers) as executor:
+            routed = list(executor.map(route, range(len(components))))
+
+        # Map each component's schedule and layout back onto the whole device.
+        laq = [-1] * num_physical
+        qal = [-1] * num_physical
+        columns = {field: [] for field in ("uid", "physicalControl", "physicalTarget", "cycle", "latency",
+                                           "is_swap")}
+
+        for (uids, result), component, region in zip(routed, components, regions):
+            # Index -1 (no control) maps to -1.
+            region = np.array(region + [-1])
+            schedule = result.scheduled_gate_arrays()
+            is_swap = np.asarray(schedule["is_swap"], dtype=bool)
+
+            columns["uid"].append(np.where(is_swap, -1, uids[np.where(is_swap, 0, schedule["uid"])]))
+            columns["physicalControl"].append(region[schedule["physicalControl"]])
+            columns["physicalTarget"].append(region[schedule["physicalTarget"]])
+            columns["cycle"].append(np.asarray(schedule["cycle"]))
+            columns["latency"].append(np.asarray(schedule["latency"]))
+            columns["is_swap"].append(is_swap)
+
+            for v, p in enumerate(list(result.inferredLaq)[:len(component)]):
+                if p >= 0:
+                    laq[component[v]] = int(region[p])
+            for p, v in enumerate(list(result.inferredQal)[:len(component)]):
+                if v >= 0:
+                    qal[int(region[p])] = component[v]
+
+        # Qubits touched by 1Q gates only are placed on any free physical qubit,
+        # and their gates need no routing.
+        free = (p for p in range(num_physical) if qal[p] < 0)
+        unrouted = np.flatnonzero(gate_component < 0)
+        for q in np.unique(targets[unrouted]).tolist():
+            p = next(free)
+            laq[q] = p
+            qal[p] = q
+
+        if len(unrouted):
+            columns["uid"].append(unrouted)
+            columns["physicalControl"].append(np.full(len(unrouted), -1))
+            columns["physicalTarget"].append(np.array([laq[q] for q in targets[unrouted].tolist()]))
+            columns["cycle"].append(np.zeros(len(unrouted), dtype=np.int64))
+            columns["latency"].append(np.zeros(len(unrouted), dtype=np.int64))
+            columns["is_swap"].append(np.zeros(len(unrouted), dtype=bool))
+
+        merged = {field: np.concatenate(arrays) for field, arrays in columns.items()}
+        order = np.argsort(merged["cycle"], kind="stable")
+        merged = {field: array[order] for field, array in merged.items()}
+
+        self.toqm_results = [result for _, result in routed]
+        self.toqm_result = ToqmCachedResult(merged, laq, qal, num_physical)
+        self._apply_schedule(mapped_dag, reg, op_nodes, self.toqm_result)
+        self._update_layout(laq, qal)
+        return True
+
+    def _run_windowed(self, mapped_dag, reg, op_nodes, gate_types, controls, targets, names, num_qubits,
+                      couplings):
+        """Routes the gates window by window, carrying the layout across windows."""
+        windows = _gate_layers(controls, targets, len(reg)) // self.window_layers
+        num_physical = self.coupling_map.size()
+
+        # The current physical to logical mapping, and for each physical qubit,
+        # the physical qubit its current contents started on.
+        qal = None
+        origin = list(range(num_physical))
+        initial_laq = None
+
+        self.toqm_results = []
+        for window in range(int(windows.max()) + 1):
+            uids = np.flatnonzero(windows == window)
+            gate_ops = toqm.GateArrays(
+                np.arange(len(uids), dtype=np.int32),
+                gate_types[uids],
+                controls[uids],
+                targets[uids],
+                names
+            )
+
+            if qal is None:
+                result = self._call_strategy(gate_ops, num_qubits, couplings)
+                qal = list(result.inferredQal)
+                initial_laq = list(result.inferredLaq)
             else:
-                mapped_dag.apply_operation_back(original_op.op, cargs=original_op.cargs, qargs=[
-                    reg[g.physicalTarget]
-                ])
+                # Place logical qubits that haven't been used yet on free physical
+                # qubits, so that each later window starts from a complete layout.
+                free = (p for p, v in enumerate(qal) if v < 0)
+                for v in range(num_qubits):
+                    if initial_laq[v] < 0:
+                        p = next(free)
+                        qal[p] = v
+                        initial_laq[v] = origin[p]
 
-        self._update_layout()
+                result = self._call_strategy(gate_ops, num_qubits, couplings, qal)
+                if list(result.inferredQal) != qal:
+                    raise TranspilerError("TOQM strategy did not route a window from its initial layout.")
 
-        return mapped_dag
+            self.toqm_results.append(result)
+            self._apply_schedule(mapped_dag, reg, op_nodes, result, uids)
+
+            schedule = result.scheduled_gate_arrays()
+            swaps = zip(
+                schedule["physicalControl"][schedule["is_swap"]].tolist(),
+                schedule["physicalTarget"][schedule["is_swap"]].tolist()
+            )
+
+            for a, b in swaps:
+                qal[a], qal[b] = qal[b], qal[a]
+                origin[a], origin[b] = origin[b], origin[a]
+
+        initial_qal = [-1] * num_physical
+        for v, p in enumerate(initial_laq):
+            if p >= 0:
+                initial_qal[p] = v
+
+        self.toqm_result = self.toqm_results[0]
+        self._update_layout(initial_laq, initial_qal)
+
+    @staticmethod
+    def _apply_schedule(mapped_dag, reg, op_nodes, result, uids=None):
+        """
+        Appends the gates scheduled in ``result`` to ``mapped_dag``.
+
+        If ``uids`` is given, it maps the UIDs used in ``result`` to indices
+        of ``op_nodes``.
+        """
+        order = result.scheduled_node_order()
+        result_uids = order["uid"] if uids is None else uids[order["uid"]]
+
+        qubits = list(reg)
+        swaps = zip(order["swap_index"].tolist(), order["swap_control"].tolist(), order["swap_target"].tolist())
+        next_swap = next(swaps, None)
+
+        for i, (uid, physical_control, physical_target) in enumerate(zip(
+                result_uids.tolist(),
+                order["physicalControl"].tolist(),
+                order["physicalTarget"].tolist())):
+            while next_swap is not None and next_swap[0] == i:
+                mapped_dag.apply_operation_back(SwapGate(), qargs=[qubits[next_swap[1]], qubits[next_swap[2]]])
+                next_swap = next(swaps, None)
+
+            original_op = op_nodes[uid]
+            if physical_control >= 0:
+                qargs = [qubits[physical_control], qubits[physical_target]]
+            else:
+                qargs = [qubits[physical_target]]
+
+            mapped_dag.apply_operation_back(original_op.op, cargs=original_op.cargs, qargs=qargs)
+
+        while next_swap is not None:
+            mapped_dag.apply_operation_back(SwapGate(), qargs=[qubits[next_swap[1]], qubits[next_swap[2]]])
+            next_swap = next(swaps, None)
 
-    def _update_layout(self):
+    def _update_layout(self, inferred_laq, inferred_qal):
         layout = self.property_set['layout']
 
         # Need to copy this mapping since layout updates
@@ -138,7 +511,7 @@ class ToqmSwap(TransformationPass):
         # Update the layout if TOQM made changes.
         ancilla_vbits = []
         for vidx in range(self.toqm_result.numPhysicalQubits):
-            pidx = self.toqm_result.inferredLaq[vidx]
+            pidx = inferred_laq[vidx]
 
             if pidx == -1:
                 # bit is not mapped to physical qubit
@@ -154,7 +527,7 @@ class ToqmSwap(TransformationPass):
                 layout[pidx] = vbit
 
         # Map any unmapped physical bits to ancilla.
-        for pidx, vidx in enumerate(self.toqm_result.inferredQal):
+        for pidx, vidx in enumerate(inferred_qal):
             if vidx < 0:
                 # Current physical bit isn't mapped. Map it to an ancilla.
                 layout[pidx] = ancilla_vbits.pop(0)
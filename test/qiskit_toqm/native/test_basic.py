@@ -1,9 +1,50 @@
+import pickle
+import types
 import unittest
 
+import numpy as np
+
 import qiskit_toqm.native as toqm
 
 
 class TestTOQM(unittest.TestCase):
+    def setUp(self) -> None:
+        super().setUp()
+        self.gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "cx", 0, 2),
+            toqm.GateOp(2, "cx", 1, 2)
+        ]
+        self.coupling = toqm.CouplingMap(3, {(0, 1), (1, 2)})
+
+    @staticmethod
+    def optimal_mapper(initial_search_cycles=0):
+        return toqm.ToqmMapper(
+            toqm.DefaultQueue(),
+            toqm.DefaultExpander(),
+            toqm.CXFrontier(),
+            toqm.Latency_1_2_6(),
+            [],
+            [toqm.HashFilter(), toqm.HashFilter2()],
+            initial_search_cycles
+        )
+
+    @staticmethod
+    def heuristic_mapper():
+        return toqm.ToqmMapper(
+            toqm.TrimSlowNodes(800, 400),
+            toqm.GreedyTopK(5),
+            toqm.CXFrontier(),
+            toqm.Latency_1_2_6(),
+            [toqm.GreedyMapper()],
+            [],
+            0
+        )
+
+    @staticmethod
+    def schedule(result):
+        return [(g.gateOp.uid, g.gateOp.type, g.physicalControl, g.physicalTarget, g.cycle)
+                for g in result.scheduledGates]
 
     def test_version(self):
         self.assertEqual(toqm.__version__, "0.1.0")
@@ -47,4 +88,230 @@ class TestTOQM(unittest.TestCase):
                 if g.gateOp.control >= 0:
                     print(f"q[{g.gateOp.control}],", end='')
                 print(f"q[{g.gateOp.target}]; ", end='')
-            print()
\ No newline at end of file
+            print()
+
+    def test_run_batch(self):
+        mapper = self.heuristic_mapper()
+        results = mapper.run_batch([self.gates] * 8, [3] * 8, self.coupling, num_threads=4)
+        expected = mapper.run(self.gates, 3, self.coupling)
+
+        self.assertEqual(len(results), 8)
+        for result in results:
+            self.assertEqual(self.schedule(result), self.schedule(expected))
+
+    def test_run_gate_arrays(self):
+        gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "h", 2),
+            toqm.GateOp(2, "cx", 0, 2),
+            toqm.GateOp(3, "cx", 1, 2)
+        ]
+
+        gate_arrays = toqm.GateArrays(
+            np.array([0, 1, 2, 3], dtype=np.int32),
+            np.array([0, 1, 0, 0], dtype=np.int32),
+            np.array([0, -1, 0, 1], dtype=np.int32),
+            np.array([1, 2, 2, 2], dtype=np.int32),
+            ["cx", "h"]
+        )
+
+        mapper = self.optimal_mapper(-1)
+        self.assertEqual(
+            self.schedule(mapper.run(gate_arrays, 3, self.coupling)),
+            self.schedule(mapper.run(gates, 3, self.coupling))
+        )
+
+    def test_gate_arrays_length_mismatch(self):
+        with self.assertRaises(ValueError):
+            toqm.GateArrays(
+                np.array([0, 1], dtype=np.int32),
+                np.array([0], dtype=np.int32),
+                np.array([-1], dtype=np.int32),
+                np.array([0], dtype=np.int32),
+                ["h"]
+            )
+
+    def test_gate_arrays_wrong_dtype(self):
+        with self.assertRaises(TypeError):
+            toqm.GateArrays(
+                np.array([0], dtype=np.int64),
+                np.array([0], dtype=np.int32),
+                np.array([-1], dtype=np.int32),
+                np.array([0], dtype=np.int32),
+                ["h"]
+            )
+
+    def test_gate_arrays_qubit_out_of_range(self):
+        gate_arrays = toqm.GateArrays(
+            np.array([0], dtype=np.int32),
+            np.array([0], dtype=np.int32),
+            np.array([-1], dtype=np.int32),
+            np.array([-2], dtype=np.int32),
+            ["h"]
+        )
+
+        with self.assertRaises(ValueError):
+            self.optimal_mapper().run(gate_arrays, 3, self.coupling)
+
+    def test_scheduled_gate_arrays(self):
+        result = self.optimal_mapper().run(self.gates, 3, self.coupling)
+        arrays = result.scheduled_gate_arrays()
+        scheduled = result.scheduledGates
+
+        self.assertEqual(arrays["uid"].tolist(), [g.gateOp.uid for g in scheduled])
+        self.assertEqual(arrays["physicalControl"].tolist(), [g.physicalControl for g in scheduled])
+        self.assertEqual(arrays["physicalTarget"].tolist(), [g.physicalTarget for g in scheduled])
+        self.assertEqual(arrays["cycle"].tolist(), [g.cycle for g in scheduled])
+        self.assertEqual(arrays["latency"].tolist(), [g.latency for g in scheduled])
+        self.assertEqual(arrays["is_swap"].tolist(), [g.gateOp.type.lower() == "swap" for g in scheduled])
+        self.assertTrue(any(arrays["is_swap"]))
+        self.assertFalse(arrays["cycle"].flags.writeable)
+
+    def test_run_batch_cancelled(self):
+        token = toqm.CancellationToken()
+        token.cancel()
+        self.assertTrue(token.cancelled)
+
+        with self.assertRaises(toqm.RoutingCancelled):
+            self.heuristic_mapper().run_batch([self.gates] * 4, [3] * 4, self.coupling, cancellation_token=token)
+
+    def test_run_portfolio(self):
+        gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "cx", 0, 2),
+            toqm.GateOp(2, "cx", 1, 2),
+            toqm.GateOp(3, "cx", 2, 3)
+        ]
+
+        coupling = toqm.CouplingMap(4, {(0, 1), (1, 2), (2, 3)})
+        mapper = self.heuristic_mapper()
+
+        def total_cycles(result):
+            return max(g.cycle + g.latency for g in result.scheduledGates)
+
+        seeds = [[0, 1, 2, 3], [3, 2, 1, 0], [1, 0, 2, 3], [0, 2, 1, 3]]
+        best = mapper.run_portfolio(gates, 4, coupling, seeds, num_threads=2)
+
+        self.assertIn(list(best.inferredQal), seeds)
+        self.assertEqual(
+            total_cycles(best),
+            min(total_cycles(mapper.run(gates, 4, coupling, seed)) for seed in seeds)
+        )
+
+    def test_run_portfolio_keeps_seeds(self):
+        """
+        Portfolio runs start from each seed as given, even with a mapper
+        that searches for an initial layout.
+        """
+        mapper = self.optimal_mapper(-1)
+        for seed in ([0, 1, 2], [2, 1, 0], [1, 0, 2]):
+            result = mapper.run_portfolio(self.gates, 3, self.coupling, [seed])
+            self.assertEqual(list(result.inferredQal), seed)
+
+    def test_result_stats(self):
+        result = self.optimal_mapper().run(self.gates, 3, self.coupling)
+        stats = result.stats
+
+        self.assertEqual(stats["num_popped"], result.numPopped)
+        self.assertEqual(stats["num_scheduled_gates"], len(result.scheduledGates))
+        self.assertEqual(stats["num_swaps"], sum(g.gateOp.type.lower() == "swap" for g in result.scheduledGates))
+        self.assertEqual(stats["total_cycles"], max(g.cycle + g.latency for g in result.scheduledGates))
+        self.assertGreaterEqual(stats.get("search_ns", 0), 0)
+
+    def test_prepared_circuit(self):
+        gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "h", 2),
+            toqm.GateOp(2, "cx", 0, 2),
+            toqm.GateOp(3, "cx", 1, 0)
+        ]
+
+        prepared = toqm.PreparedCircuit(gates, 3)
+        self.assertEqual(len(prepared), 4)
+
+        mapper = self.optimal_mapper(-1)
+        from_list = mapper.run(gates, 3, self.coupling)
+        batch = mapper.run_batch(circuits=[prepared, prepared], coupling_map=self.coupling, num_threads=2)
+        portfolio = mapper.run_portfolio(circuit=prepared, num_qubits=3, coupling_map=self.coupling,
+                                         initial_layouts=[[0, 1, 2]])
+
+        self.assertEqual(self.schedule(mapper.run(prepared, 3, self.coupling)), self.schedule(from_list))
+        self.assertEqual([self.schedule(r) for r in batch], [self.schedule(from_list)] * 2)
+        self.assertEqual(self.schedule(portfolio),
+                         self.schedule(self.optimal_mapper().run(gates, 3, self.coupling, [0, 1, 2])))
+
+        with self.assertRaises(ValueError):
+            mapper.run(prepared, 4, self.coupling)
+
+        with self.assertRaises(ValueError):
+            toqm.PreparedCircuit(gates, 2)
+
+    def test_pickle_result(self):
+        gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "cx", 0, 2),
+            toqm.GateOp(2, "h", 2)
+        ]
+
+        result = self.optimal_mapper().run(gates, 3, self.coupling)
+        restored = pickle.loads(pickle.dumps(result))
+
+        def fields(r):
+            return (
+                [(g.gateOp.uid, g.gateOp.type, g.gateOp.control, g.gateOp.target,
+                  g.physicalControl, g.physicalTarget, g.cycle, g.latency) for g in r.scheduledGates],
+                list(r.laq), list(r.inferredQal), list(r.inferredLaq), r.numPhysicalQubits,
+                r.numLogicalQubits, r.idealCycles, r.numPopped, r.remainingInQueue, r.filterStats
+            )
+
+        self.assertEqual(fields(restored), fields(result))
+        self.assertEqual(restored.stats, result.stats)
+        self.assertEqual(fields(toqm.ToqmResult.from_bytes(result.to_bytes())), fields(result))
+
+        with self.assertRaises(ValueError):
+            toqm.ToqmResult.from_bytes(result.to_bytes()[:-1])
+
+    def test_pickle_latency_description(self):
+        description = toqm.LatencyDescription("cx", 0, 1, 3)
+        restored = pickle.loads(pickle.dumps(description))
+
+        self.assertEqual(
+            (restored.numQubits, restored.type, restored.control, restored.target, restored.latency),
+            (description.numQubits, description.type, description.control, description.target, description.latency)
+        )
+
+    def test_gate_arrays_from_nodes(self):
+        def node(name, *qargs):
+            return types.SimpleNamespace(op=types.SimpleNamespace(name=name), qargs=qargs)
+
+        a, b, c = object(), object(), object()
+        gate_arrays = toqm.GateArrays.from_nodes(
+            [node("h", a), node("cx", a, c), node("cx", c, b), node("rz", b)],
+            {a: 0, b: 1, c: 2}
+        )
+
+        self.assertEqual(gate_arrays.uids.tolist(), [0, 1, 2, 3])
+        self.assertEqual(gate_arrays.names, ["h", "cx", "rz"])
+        self.assertEqual(gate_arrays.types.tolist(), [0, 1, 1, 2])
+        self.assertEqual(gate_arrays.controls.tolist(), [-1, 0, 2, -1])
+        self.assertEqual(gate_arrays.targets.tolist(), [0, 2, 1, 1])
+
+        with self.assertRaises(ValueError):
+            toqm.GateArrays.from_nodes([node("ccx", a, b, c)], {a: 0, b: 1, c: 2})
+
+    def test_scheduled_node_order(self):
+        result = self.optimal_mapper().run(self.gates, 3, self.coupling)
+        order = result.scheduled_node_order()
+
+        # Interleaving the swaps back into the original gates gives the schedule.
+        rebuilt = [(uid, c, t) for uid, c, t in zip(
+            order["uid"].tolist(), order["physicalControl"].tolist(), order["physicalTarget"].tolist())]
+        for i, c, t in reversed(list(zip(
+                order["swap_index"].tolist(), order["swap_control"].tolist(), order["swap_target"].tolist()))):
+            rebuilt.insert(i, ("swap", c, t))
+
+        self.assertEqual(
+            rebuilt,
+            [("swap" if g.gateOp.type == "swap" else g.gateOp.uid, g.physicalControl, g.physicalTarget)
+             for g in result.scheduledGates]
+        )
@@ -1,7 +1,11 @@
 import unittest
+from unittest import mock
 
+import qiskit_toqm.toqm_latency
 from qiskit_toqm.toqm_latency import latencies_from_target
-from qiskit.transpiler import CouplingMap, InstructionDurations, TranspilerError
+from qiskit.circuit import Parameter
+from qiskit.circuit.library import CXGate, RZGate, SXGate
+from qiskit.transpiler import CouplingMap, InstructionDurations, InstructionProperties, Target, TranspilerError
 from qiskit.providers.fake_provider import FakeMontrealV2
 
 
@@ -184,3 +188,50 @@ class TestBuildLatencyDescriptions(unittest.TestCase):
         self.assertTrue(
             all(x.latency == 3 for x in latencies if x.type == "swap")
         )
+
+    def test_swap_durations_per_coupling(self):
+        """
+        Swap durations are scheduled on each coupling from a shared decomposition,
+        and are calculated once per target.
+        """
+        target = Target(num_qubits=3)
+        target.add_instruction(RZGate(Parameter("theta")), {(q,): InstructionProperties(duration=0) for q in range(3)})
+        target.add_instruction(SXGate(), {(q,): InstructionProperties(duration=1e-8) for q in range(3)})
+        target.add_instruction(CXGate(), {
+            (0, 1): InstructionProperties(duration=1e-7),
+            (1, 0): InstructionProperties(duration=1e-7),
+            (1, 2): InstructionProperties(duration=2e-7),
+            (2, 1): InstructionProperties(duration=2e-7)
+        })
+
+        with mock.patch.object(qiskit_toqm.toqm_latency, "_calc_swap_durations",
+                               wraps=qiskit_toqm.toqm_latency._calc_swap_durations) as calc:
+            latencies = list(latencies_from_target(target=target, normalize_scale=1))
+            list(latencies_from_target(target=target, normalize_scale=1))
+
+        self.assertEqual(calc.call_count, 1)
+
+        swaps = {(x.control, x.target): x.latency for x in latencies if x.type == "swap"}
+        self.assertEqual(swaps, {(0, 1): 30, (1, 0): 30, (1, 2): 60, (2, 1): 60})
+
+    def test_swap_durations_follow_target_changes(self):
+        """
+        Swap durations are recalculated once the target's durations change.
+        """
+        target = Target(num_qubits=2)
+        target.add_instruction(SXGate(), {(q,): InstructionProperties(duration=1e-8) for q in range(2)})
+        target.add_instruction(RZGate(Parameter("theta")), {(q,): InstructionProperties(duration=0) for q in range(2)})
+        target.add_instruction(CXGate(), {
+            (0, 1): InstructionProperties(duration=1e-7),
+            (1, 0): InstructionProperties(duration=1e-7)
+        })
+
+        def swap_latencies():
+            return {(x.control, x.target): x.latency for x in latencies_from_target(target=target, normalize_scale=1)
+                    if x.type == "swap"}
+
+        before = swap_latencies()
+        target.update_instruction_properties("cx", (0, 1), InstructionProperties(duration=2e-7))
+        target.update_instruction_properties("cx", (1, 0), InstructionProperties(duration=2e-7))
+
+        self.assertNotEqual(swap_latencies(), before)
@@ -0,0 +1,38 @@
+import unittest
+
+from qiskit import QuantumCircuit, transpile
+from qiskit.transpiler import CouplingMap
+
+from qiskit_toqm import ToqmStrategyO0
+
+
+class TestToqmSwapPlugin(unittest.TestCase):
+    def test_transpile_without_durations(self):
+        """
+        Routing through the plugin needs no target or instruction durations.
+        """
+        circuit = QuantumCircuit(3)
+        circuit.h(0)
+        circuit.cx(0, 2)
+        circuit.cx(1, 2)
+        circuit.cx(0, 1)
+
+        for optimization_level in range(4):
+            transpiled = transpile(
+                circuit,
+                coupling_map=CouplingMap.from_line(3),
+                basis_gates=["cx", "rz", "sx", "x"],
+                routing_method="toqm",
+                optimization_level=optimization_level
+            )
+            self.assertEqual(transpiled.num_qubits, 3)
+
+    def test_presets_ignore_latencies(self):
+        """
+        Presets do not evaluate the latencies they are given.
+        """
+        def latencies():
+            raise AssertionError("The latencies were evaluated.")
+            yield
+
+        ToqmStrategyO0(latencies())
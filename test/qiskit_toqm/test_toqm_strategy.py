@@ -0,0 +1,35 @@
+import threading
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+
+import qiskit_toqm.native as toqm
+from qiskit_toqm import ToqmHeuristicStrategy, latencies_from_simple
+
+
+class TestToqmStrategy(unittest.TestCase):
+    def test_concurrent_calls(self):
+        """
+        Concurrent calls route on a native mapper per thread, and match a serial call.
+        """
+        strategy = ToqmHeuristicStrategy(latencies_from_simple(1, 2, 6), top_k=5, queue_target=400, queue_max=800)
+        gates = [
+            toqm.GateOp(0, "cx", 0, 1),
+            toqm.GateOp(1, "cx", 0, 2),
+            toqm.GateOp(2, "cx", 1, 2)
+        ]
+        coupling = toqm.CouplingMap(3, {(0, 1), (1, 2)})
+
+        def schedule(result):
+            return [(g.gateOp.uid, g.physicalControl, g.physicalTarget, g.cycle) for g in result.scheduledGates]
+
+        barrier = threading.Barrier(4)
+
+        def route(_):
+            barrier.wait()
+            return strategy._thread_mappers()[0], schedule(strategy(gates, 3, coupling))
+
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            routed = list(executor.map(route, range(4)))
+
+        self.assertEqual(len({id(mapper) for mapper, _ in routed} | {id(strategy.mapper)}), 5)
+        self.assertEqual([s for _, s in routed], [schedule(strategy(gates, 3, coupling))] * 4)
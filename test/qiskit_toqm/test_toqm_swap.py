@@ -0,0 +1,221 @@
+import pickle
+import tempfile
+import unittest
+from unittest import mock
+
+from qiskit import QuantumCircuit, QuantumRegister
+from qiskit.quantum_info import Operator
+from qiskit.transpiler import CouplingMap, Layout, PassManager, TranspilerError
+from qiskit.transpiler.passes import ApplyLayout, CheckMap, EnlargeWithAncilla, FullAncillaAllocation, SetLayout
+
+import qiskit_toqm.native as toqm
+from qiskit_toqm import (ToqmDiskCache, ToqmHeuristicStrategy, ToqmMemoryCache, ToqmSwap, ToqmStrategyO0,
+                         ToqmStrategyO3)
+from qiskit_toqm.toqm_cache import routing_key
+
+
+class TestToqmSwap(unittest.TestCase):
+    def setUp(self) -> None:
+        super().setUp()
+        self.coupling_map = CouplingMap.from_line(5)
+
+        qr = QuantumRegister(5, "q")
+        self.circuit = QuantumCircuit(qr)
+        for _ in range(4):
+            self.circuit.h(0)
+            self.circuit.cx(0, 4)
+            self.circuit.cx(1, 3)
+            self.circuit.cx(2, 4)
+            self.circuit.cx(0, 2)
+
+    def route(self, routing_pass, circuit=None, coupling_map=None):
+        circuit = self.circuit if circuit is None else circuit
+        coupling_map = self.coupling_map if coupling_map is None else coupling_map
+        pm = PassManager([
+            SetLayout(Layout.generate_trivial_layout(*circuit.qregs)),
+            FullAncillaAllocation(coupling_map),
+            EnlargeWithAncilla(),
+            ApplyLayout(),
+            routing_pass,
+            CheckMap(coupling_map)
+        ])
+
+        routed = pm.run(circuit)
+        self.assertTrue(pm.property_set["is_swap_mapped"])
+        self.routed_layout = pm.property_set["layout"]
+        return routed
+
+    def assertRoutedEquivalent(self, circuit, routed):
+        """
+        Asserts that ``routed`` (as returned by the last ``route``) applies
+        ``circuit`` on the initial layout chosen by the router, followed by
+        the permutation of its swaps.
+        """
+        expected = QuantumCircuit(routed.num_qubits)
+        expected.compose(circuit, qubits=[self.routed_layout[q] for q in circuit.qubits], inplace=True)
+        for instruction in routed.data:
+            if instruction.operation.name == "swap":
+                expected.swap(*(routed.find_bit(q).index for q in instruction.qubits))
+
+        self.assertTrue(Operator(routed).equiv(Operator(expected)))
+
+    def test_windowed_routing(self):
+        """
+        Routing in windows maps every gate onto the coupling map.
+        """
+        routing_pass = ToqmSwap(self.coupling_map, ToqmStrategyO0([]), window_layers=2)
+        routed = self.route(routing_pass)
+
+        self.assertGreater(len(routing_pass.toqm_results), 1)
+        counts = routed.count_ops()
+        self.assertEqual(counts["cx"], self.circuit.count_ops()["cx"])
+        self.assertEqual(counts["h"], self.circuit.count_ops()["h"])
+
+    def test_windowed_optimal_routing(self):
+        """
+        Windows after the first keep the layout they are seeded with when
+        routed by a layout-searching optimal strategy.
+        """
+        routing_pass = ToqmSwap(self.coupling_map, ToqmStrategyO3([]), window_layers=2)
+        routed = self.route(routing_pass)
+
+        self.assertGreater(len(routing_pass.toqm_results), 1)
+        self.assertRoutedEquivalent(self.circuit, routed)
+
+    def test_invalid_window(self):
+        with self.assertRaises(TranspilerError):
+            ToqmSwap(self.coupling_map, ToqmStrategyO0([]), window_layers=0)
+
+    def check_cache(self, cache):
+        """
+        A cached routing is replayed, without a search, onto a circuit that
+        differs only in gate parameters.
+        """
+        strategy = ToqmStrategyO0([])
+        calls = []
+
+        def counting_strategy(*args):
+            calls.append(args)
+            return strategy(*args)
+
+        counting_strategy.cache_key = strategy.cache_key
+
+        def ansatz(theta):
+            circuit = self.circuit.copy()
+            for q in range(5):
+                circuit.rz(theta, q)
+            return circuit
+
+        first = self.route(ToqmSwap(self.coupling_map, counting_strategy, cache=cache), ansatz(0.1))
+        second = self.route(ToqmSwap(self.coupling_map, counting_strategy, cache=cache), ansatz(0.2))
+
+        self.assertEqual(len(calls), 1)
+        self.assertEqual(first.count_ops(), second.count_ops())
+        self.assertEqual(
+            [(inst.operation.name, [first.find_bit(q).index for q in inst.qubits]) for inst in first.data],
+            [(inst.operation.name, [second.find_bit(q).index for q in inst.qubits]) for inst in second.data]
+        )
+
+    def test_memory_cache(self):
+        self.check_cache(ToqmMemoryCache())
+
+    def test_pickled_memory_cache(self):
+        """
+        A pickled memory cache keeps its entries and can be used afterwards.
+        """
+        cache = ToqmMemoryCache()
+        strategy = ToqmStrategyO0([])
+        routed = self.route(ToqmSwap(self.coupling_map, strategy, cache=cache))
+
+        restored = pickle.loads(pickle.dumps(cache))
+        self.assertEqual(len(restored), len(cache))
+        self.assertEqual(self.route(ToqmSwap(self.coupling_map, strategy, cache=restored)).count_ops(),
+                         routed.count_ops())
+
+    def test_disk_cache(self):
+        with tempfile.TemporaryDirectory() as directory:
+            self.check_cache(ToqmDiskCache(directory))
+
+    def test_routing_key_covers_version(self):
+        """
+        Cached routings are not replayed by another version of the native module.
+        """
+        args = ([0], [0], [1], ["cx"], 2, 2, [(0, 1)], "strategy")
+        key = routing_key(*args)
+        with mock.patch.object(toqm, "__version__", "0.0.0-other"):
+            self.assertNotEqual(routing_key(*args), key)
+
+    def test_cache_requires_cache_key(self):
+        with self.assertRaises(TranspilerError):
+            ToqmSwap(self.coupling_map, lambda *args: None, cache=ToqmMemoryCache())
+
+    def test_pickled_strategy(self):
+        """
+        A strategy rebuilt from a pickle routes the same way as the original.
+        """
+        strategy = ToqmStrategyO0([])
+        restored = pickle.loads(pickle.dumps(strategy))
+
+        self.assertEqual(restored.cache_key, strategy.cache_key)
+        self.assertEqual(
+            self.route(ToqmSwap(self.coupling_map, restored)).count_ops(),
+            self.route(ToqmSwap(self.coupling_map, strategy)).count_ops()
+        )
+
+    def test_gate_op_list_strategy(self):
+        """
+        A strategy that does not set ``accepts_gate_arrays`` receives a list of ``GateOp``.
+        """
+        strategy = ToqmStrategyO0([])
+        received = []
+
+        def list_strategy(gate_ops, num_qubits, coupling_map):
+            received.append(gate_ops)
+            return strategy(gate_ops, num_qubits, coupling_map)
+
+        self.assertEqual(
+            self.route(ToqmSwap(self.coupling_map, list_strategy)).count_ops(),
+            self.route(ToqmSwap(self.coupling_map, strategy)).count_ops()
+        )
+        self.assertIsInstance(received[0], list)
+        self.assertEqual(len(received[0]), 20)
+
+    def test_partitioned_routing(self):
+        """
+        Qubit-disjoint components are routed separately and merged into
+        a single mapped circuit equivalent to the original.
+        """
+        # Components {0, 1, 3} and {2, 4}. Qubit 5 sees 1Q gates only, and
+        # the 7th physical qubit is an idle ancilla.
+        coupling_map = CouplingMap.from_line(7)
+        qr = QuantumRegister(6, "q")
+        circuit = QuantumCircuit(qr)
+        for _ in range(3):
+            circuit.cx(0, 3)
+            circuit.t(0)
+            circuit.cx(3, 1)
+            circuit.h(2)
+            circuit.cx(2, 4)
+            circuit.cx(1, 0)
+            circuit.h(5)
+            circuit.t(5)
+
+        routing_pass = ToqmSwap(coupling_map, ToqmStrategyO0([]), partition=True)
+        routed = self.route(routing_pass, circuit, coupling_map)
+
+        self.assertEqual(len(routing_pass.toqm_results), 2)
+        self.assertEqual(routed.count_ops()["cx"], circuit.count_ops()["cx"])
+        self.assertRoutedEquivalent(circuit, routed)
+
+    def test_invalid_partition(self):
+        with self.assertRaises(TranspilerError):
+            ToqmSwap(self.coupling_map, ToqmStrategyO0([]), window_layers=2, partition=True)
+
+    def test_partition_requires_qubit_independent_latencies(self):
+        strategy = ToqmHeuristicStrategy([toqm.LatencyDescription("cx", 0, 1, 3)], 10, 100, 200)
+        self.assertFalse(strategy.qubit_independent_latencies)
+        with self.assertRaises(TranspilerError):
+            ToqmSwap(self.coupling_map, strategy, partition=True)
+
+        with self.assertRaises(TranspilerError):
+            ToqmSwap(self.coupling_map, lambda gates, num_qubits, coupling_map: None, partition=True)